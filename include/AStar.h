@@ -0,0 +1,178 @@
+#pragma once
+#include "Coord.h"
+#include "Pathfinding.h"
+#include "RobinHoodMap.h"
+#include "World.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+// ============================================================================
+//  A* — Heuristic Search over the Same Moves as bfs_search
+// ============================================================================
+//
+//  Expands cells in order of f = g + weight * h instead of level by level,
+//  so in open terrain it heads straight for the target rather than
+//  flooding a diamond around the start. Moves come from the generators
+//  the BFS uses (for_each_step over can_step, or for_each_move over a
+//  move mask), and every move costs 1 as in the BFS.
+//
+//  1. open list — a binary heap of (f, g, cell) on a plain vector; ties on
+//                 f go to the larger g, the cell nearer the target
+//  2. visited   — a RobinHoodMap from cell to best g and the PATH_DIRS
+//                 index of the move that reached it; the path is read
+//                 back from the target
+//
+//  Heuristics, with dx, dy the distance left on each axis:
+//
+//  - CHEBYSHEV  max(dx, dy). A diagonal costs 1 like any other move, so
+//               this never overestimates: with weight 1 the path is as
+//               short as bfs_search's.
+//  - OCTILE     max + (sqrt 2 - 1) * min, the grid distance when a
+//               diagonal costs sqrt 2. Under unit moves it overestimates
+//               diagonal runs by up to 41%, which acts as a built-in
+//               weighting.
+//
+//  weight > 1 trades path length for fewer expansions: the result is at
+//  most weight times longer than the shortest (CHEBYSHEV). Paths longer
+//  than max_depth moves are not searched, as with bfs_search.
+//
+// ============================================================================
+
+enum class Heuristic { CHEBYSHEV, OCTILE };
+
+inline float heuristic_distance(Heuristic h, Coord a, Coord b) {
+  int dx = std::abs(a.x - b.x);
+  int dy = std::abs(a.y - b.y);
+  int lo = std::min(dx, dy), hi = std::max(dx, dy);
+  if (h == Heuristic::OCTILE)
+    return static_cast<float>(hi) + 0.41421356f * static_cast<float>(lo);
+  return static_cast<float>(hi);
+}
+
+// A* over a move generator: steps(cur, fn) calls fn(m, nei) for each
+// legal move from cur, as in bfs_search_steps
+template <typename Steps>
+inline std::vector<Coord>
+astar_search_steps(Coord s, Coord tar, Steps &&steps, int max_depth = 80,
+                   Heuristic heuristic = Heuristic::CHEBYSHEV,
+                   float weight = 1.0f, size_t *expanded = nullptr) {
+  if (expanded)
+    *expanded = 0;
+  if (s == tar)
+    return {s};
+
+  struct Open {
+    float f;
+    uint32_t g;
+    Coord pos;
+    // std heaps keep the largest on top: invert to pop the smallest f
+    bool operator<(const Open &o) const {
+      return f != o.f ? f > o.f : g < o.g;
+    }
+  };
+  struct Seen {
+    uint32_t g;
+    uint8_t move; // PATH_DIRS index into this cell; unused for s
+    bool closed;
+  };
+
+  std::vector<Open> open;
+  open.reserve(256);
+  RobinHoodMap<Coord, Seen, CoordHash> seen;
+  seen.reserve(256);
+
+  auto h = [&](Coord c) {
+    return weight * heuristic_distance(heuristic, c, tar);
+  };
+  seen.try_emplace(s, Seen{0, 0, false});
+  open.push_back({h(s), 0, s});
+
+  size_t popped = 0;
+  bool found = false;
+  while (!open.empty()) {
+    std::pop_heap(open.begin(), open.end());
+    Open cur = open.back();
+    open.pop_back();
+    Seen &cs = (*seen.find(cur.pos)).second;
+    if (cs.closed || cs.g < cur.g)
+      continue; // stale entry
+    cs.closed = true;
+    ++popped;
+    if (cur.pos == tar) {
+      found = true;
+      break;
+    }
+    uint32_t g = cur.g + 1;
+    if (g > static_cast<uint32_t>(max_depth))
+      continue;
+
+    steps(cur.pos, [&](uint8_t m, Coord nei) {
+      auto [it, inserted] = seen.try_emplace(nei, Seen{g, m, false});
+      if (!inserted) {
+        Seen &ns = (*it).second;
+        if (ns.closed || ns.g <= g)
+          return;
+        ns.g = g;
+        ns.move = m;
+      }
+      open.push_back({static_cast<float>(g) + h(nei), g, nei});
+      std::push_heap(open.begin(), open.end());
+    });
+  }
+
+  if (expanded)
+    *expanded = popped;
+  if (!found)
+    return {};
+
+  std::vector<Coord> path;
+  for (Coord c = tar; c != s;) {
+    path.push_back(c);
+    c = c - PATH_DIRS[(*seen.find(c)).second.move];
+  }
+  path.push_back(s);
+  std::reverse(path.begin(), path.end());
+  return path;
+}
+
+// A* over can_step, asking is_air(x, y) as bfs_search does
+template <typename IsAir>
+inline std::vector<Coord>
+astar_search(Coord s, Coord tar, IsAir &&is_air, int max_depth = 80,
+             Heuristic heuristic = Heuristic::CHEBYSHEV, float weight = 1.0f,
+             size_t *expanded = nullptr) {
+  return astar_search_steps(
+      s, tar,
+      [&](Coord cur, auto &&fn) { for_each_step(cur, is_air, fn); },
+      max_depth, heuristic, weight, expanded);
+}
+
+// The same A* with each cell's moves read whole: moves(cur) returns cur's
+// move_mask, as in bfs_search_masked
+template <typename Moves>
+inline std::vector<Coord>
+astar_search_masked(Coord s, Coord tar, Moves &&moves, int max_depth = 80,
+                    Heuristic heuristic = Heuristic::CHEBYSHEV,
+                    float weight = 1.0f, size_t *expanded = nullptr) {
+  return astar_search_steps(
+      s, tar,
+      [&](Coord cur, auto &&fn) { for_each_move(cur, moves(cur), fn); },
+      max_depth, heuristic, weight, expanded);
+}
+
+// bfs_findpath searched with A*: the same reachability check, then the
+// World's move masks, one byte per expansion
+inline std::vector<Coord>
+astar_findpath(Coord s, Coord tar, World &world, int max_depth = 80,
+               Heuristic heuristic = Heuristic::CHEBYSHEV,
+               float weight = 1.0f) {
+  if (!world.may_reach(s, tar))
+    return {};
+  World::Cursor cursor(world);
+  return astar_search_masked(
+      s, tar, [&](Coord c) { return cursor.moves(c.x, c.y); }, max_depth,
+      heuristic, weight);
+}
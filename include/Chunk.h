@@ -1,44 +1,136 @@
 #pragma once
 #include "BlockType.h"
 #include "Coord.h"
+#include "PackedBlocks.h"
 #include "Pixel.h"
 #include "Terrain.h"
 #include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
 #include <iostream>
 
+inline PackedBlocks generate_chunk_blocks(Coord pos) {
+  BlockType fill;
+  if (chunk_is_uniform(pos.y, fill))
+    return PackedBlocks(fill);
+  std::array<std::array<BlockType, CHUNK_SIZE>, CHUNK_SIZE> grid;
+  generate_chunk_terrain(grid, pos.x);
+  return PackedBlocks(grid);
+}
+
 class Chunk {
-  std::array<std::array<BlockType, CHUNK_SIZE>, CHUNK_SIZE> blocks;
+  PackedBlocks blocks;
   Coord position;
+  // Bit xx of solid_rows[yy] is set when (xx, yy) is anything but AIR.
+  // Kept in sync by every constructor and set_block.
+  std::array<uint32_t, CHUNK_SIZE> solid_rows{};
+  static_assert(CHUNK_SIZE <= 32, "one uint32_t per solidity row");
+  // Stamp from a process-wide counter, taken on construction and whenever
+  // set_block flips a cell between air and solid: no two solidity states
+  // of any chunks share one, so caches can key on (position, version)
+  uint64_t version = next_solidity_version();
+
+  // World residency bookkeeping: LRU links + "differs from generated terrain"
+  // + "read-only instance standing in for every uniform chunk of one fill"
+  friend class World;
+  Chunk *lru_prev = nullptr;
+  Chunk *lru_next = nullptr;
+  bool modified = false;
+  bool shared = false;
 
 public:
-  Chunk(Coord pos) : position(pos) { generate_terrain(); }
+  Chunk(Coord pos) : position(pos) {
+    generate_terrain();
+    rebuild_solidity();
+  }
 
-  Chunk(Coord pos, std::array<std::array<BlockType, CHUNK_SIZE>, CHUNK_SIZE> d)
-      : blocks(std::move(d)), position(pos) {}
+  Chunk(Coord pos,
+        const std::array<std::array<BlockType, CHUNK_SIZE>, CHUNK_SIZE> &d)
+      : blocks(d), position(pos) {
+    rebuild_solidity();
+  }
+
+  Chunk(Coord pos, PackedBlocks d) : blocks(std::move(d)), position(pos) {
+    rebuild_solidity();
+  }
 
-  const std::array<std::array<BlockType, CHUNK_SIZE>, CHUNK_SIZE> &
-  get_blocks() const {
-    return blocks;
+  // Unpacked copy of the cells; use get_packed() to avoid the expansion
+  std::array<std::array<BlockType, CHUNK_SIZE>, CHUNK_SIZE> get_blocks() const {
+    return blocks.unpack();
   }
 
+  const PackedBlocks &get_packed() const { return blocks; }
+
   BlockType get_block(int xx, int yy) const {
     if (xx < 0 or xx >= CHUNK_SIZE or yy < 0 or yy >= CHUNK_SIZE) {
       return BlockType::AIR;
     }
-    return blocks[yy][xx];
+    return blocks.get(yy * CHUNK_SIZE + xx);
   }
 
   void set_block(int xx, int yy, BlockType type) {
+    assert(!shared && "write through World to copy a shared chunk first");
     if (xx < 0 or xx >= CHUNK_SIZE or yy < 0 or yy >= CHUNK_SIZE) {
       return;
     }
-    blocks[yy][xx] = type;
+    blocks.set(yy * CHUNK_SIZE + xx, type);
+    uint32_t bit = 1u << xx;
+    uint32_t old = solid_rows[yy];
+    if (type == BlockType::AIR)
+      solid_rows[yy] &= ~bit;
+    else
+      solid_rows[yy] |= bit;
+    if (solid_rows[yy] != old)
+      version = next_solidity_version();
+    modified = true;
+  }
+
+  // Same answer as get_block(xx, yy) == AIR, from one bit
+  bool is_air(int xx, int yy) const {
+    if (xx < 0 or xx >= CHUNK_SIZE or yy < 0 or yy >= CHUNK_SIZE) {
+      return true;
+    }
+    return !((solid_rows[yy] >> xx) & 1u);
+  }
+
+  // Bit xx set = (xx, yy) solid
+  uint32_t solid_row(int yy) const { return solid_rows[yy]; }
+
+  // Bit yy set = (xx, yy) solid
+  uint32_t solid_column(int xx) const {
+    uint32_t col = 0;
+    for (int yy = 0; yy < CHUNK_SIZE; ++yy) {
+      col |= ((solid_rows[yy] >> xx) & 1u) << yy;
+    }
+    return col;
+  }
+
+  uint64_t solidity_version() const { return version; }
+
+  bool is_modified() const { return modified; }
+  bool is_shared() const { return shared; }
+
+  // Copy n blocks of row yy starting at column xx; caller keeps it in-chunk
+  void copy_row(int xx, int yy, int n, BlockType *out) const {
+    blocks.unpack_span(yy * CHUNK_SIZE + xx, n, out);
   }
 
   Coord get_position() const { return position; }
 
 private:
-  void generate_terrain() { generate_chunk_terrain(blocks, position.x); }
+  static uint64_t next_solidity_version() {
+    static std::atomic<uint64_t> clock{0};
+    return clock.fetch_add(1, std::memory_order_relaxed) + 1;
+  }
+
+  void generate_terrain() { blocks = generate_chunk_blocks(position); }
+
+  void rebuild_solidity() {
+    for (int yy = 0; yy < CHUNK_SIZE; ++yy) {
+      solid_rows[yy] = blocks.solid_row(yy);
+    }
+  }
 };
 
 inline void print_chunk(const Chunk &chunk) {
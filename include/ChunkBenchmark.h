@@ -0,0 +1,373 @@
+#pragma once
+#include "BlockType.h"
+#include "Chunk.h"
+#include "FastRand.h"
+#include "MobStorage.h"
+#include "PackedBlocks.h"
+#include "RobinHoodMap.h"
+#include "SaveLoad.h"
+#include "Terrain.h"
+#include "World.h"
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <fstream>
+#include <unistd.h>
+#endif
+
+// Current resident set size of this process in KB (0 if unavailable).
+// Unlike the peak, this falls when memory goes back to the OS, so the
+// difference across a phase is what that phase holds.
+inline size_t current_rss_kb() {
+#ifdef _WIN32
+  PROCESS_MEMORY_COUNTERS pmc;
+  if (K32GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+    return pmc.WorkingSetSize / 1024;
+  return 0;
+#else
+  std::ifstream statm("/proc/self/statm");
+  size_t pages = 0, resident = 0;
+  if (!(statm >> pages >> resident))
+    return 0;
+  return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE)) / 1024;
+#endif
+}
+
+// ============================================================================
+//  Chunk Storage Benchmark: 1 byte/block array vs PackedBlocks (4-bit)
+// ============================================================================
+//
+//  Tests: Sequential Read, Random Read, Random Write over many generated
+//         chunks, so the working set is larger than L1/L2 like a real World.
+//
+// ============================================================================
+
+inline void run_chunk_storage_benchmark() {
+  using Grid = std::array<std::array<BlockType, CHUNK_SIZE>, CHUNK_SIZE>;
+
+  const int NUM_CHUNKS = 2048;
+  const int SEQ_PASSES = 20;
+  const int NUM_RANDOM = 2000000;
+
+  std::cout << "\n========================================\n";
+  std::cout << "   CHUNK STORAGE BENCHMARK\n";
+  std::cout << "   byte array vs PackedBlocks\n";
+  std::cout << "   " << NUM_CHUNKS << " chunks, " << NUM_RANDOM
+            << " random accesses\n";
+  std::cout << "========================================\n\n";
+
+  std::vector<Grid> byte_chunks(NUM_CHUNKS);
+  std::vector<PackedBlocks> packed_chunks(NUM_CHUNKS);
+  for (int c = 0; c < NUM_CHUNKS; ++c) {
+    generate_chunk_terrain(byte_chunks[c], c);
+    packed_chunks[c].assign(byte_chunks[c]);
+  }
+
+  // Pre-generate random (chunk, cell) pairs shared by both layouts
+  std::vector<int> rnd_chunk(NUM_RANDOM);
+  std::vector<int> rnd_cell(NUM_RANDOM);
+  for (int i = 0; i < NUM_RANDOM; ++i) {
+    rnd_chunk[i] = static_cast<int>(fast_rand() % NUM_CHUNKS);
+    rnd_cell[i] = static_cast<int>(fast_rand() % PackedBlocks::CELLS);
+  }
+
+  size_t byte_mem = sizeof(Grid) * NUM_CHUNKS;
+  size_t packed_mem = 0;
+  for (const auto &pc : packed_chunks) {
+    packed_mem += pc.memory_bytes();
+  }
+
+  std::cout << "--- Memory ---\n";
+  std::cout << "  byte array:    " << byte_mem / 1024 << " KB ("
+            << sizeof(Grid) << " B/chunk)\n";
+  std::cout << "  PackedBlocks:  " << packed_mem / 1024 << " KB ("
+            << packed_mem / NUM_CHUNKS << " B/chunk)\n\n";
+
+  volatile int sink = 0;
+
+  // ---- BENCHMARK 1: SEQUENTIAL READ ----
+  std::cout << "--- Sequential Read ---\n";
+
+  auto t1 = std::chrono::high_resolution_clock::now();
+  int acc = 0;
+  for (int pass = 0; pass < SEQ_PASSES; ++pass) {
+    for (int c = 0; c < NUM_CHUNKS; ++c) {
+      for (int y = 0; y < CHUNK_SIZE; ++y) {
+        for (int x = 0; x < CHUNK_SIZE; ++x) {
+          acc += static_cast<int>(byte_chunks[c][y][x]);
+        }
+      }
+    }
+  }
+  sink = acc;
+  auto t2 = std::chrono::high_resolution_clock::now();
+  auto byte_seq =
+      std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count();
+
+  t1 = std::chrono::high_resolution_clock::now();
+  acc = 0;
+  for (int pass = 0; pass < SEQ_PASSES; ++pass) {
+    for (int c = 0; c < NUM_CHUNKS; ++c) {
+      for (int i = 0; i < PackedBlocks::CELLS; ++i) {
+        acc += static_cast<int>(packed_chunks[c].get(i));
+      }
+    }
+  }
+  sink = acc;
+  t2 = std::chrono::high_resolution_clock::now();
+  auto packed_get =
+      std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count();
+
+  // How sequential readers (rendering, copy_region, solidity) actually
+  // read: a row span at a time, two cells per index byte
+  t1 = std::chrono::high_resolution_clock::now();
+  acc = 0;
+  BlockType row[CHUNK_SIZE];
+  for (int pass = 0; pass < SEQ_PASSES; ++pass) {
+    for (int c = 0; c < NUM_CHUNKS; ++c) {
+      for (int y = 0; y < CHUNK_SIZE; ++y) {
+        packed_chunks[c].unpack_span(y * CHUNK_SIZE, CHUNK_SIZE, row);
+        for (int x = 0; x < CHUNK_SIZE; ++x) {
+          acc += static_cast<int>(row[x]);
+        }
+      }
+    }
+  }
+  sink = acc;
+  t2 = std::chrono::high_resolution_clock::now();
+  auto packed_seq =
+      std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count();
+
+  double seq_ratio =
+      static_cast<double>(byte_seq) / static_cast<double>(packed_seq);
+  std::cout << "  byte array:    " << byte_seq << " us\n";
+  std::cout << "  PackedBlocks:  " << packed_get << " us (get per cell)\n";
+  std::cout << "  PackedBlocks:  " << packed_seq << " us (row spans)\n";
+  std::cout << "  Speedup:       " << seq_ratio << "x (row spans), "
+            << static_cast<double>(byte_seq) / static_cast<double>(packed_get)
+            << "x (get)\n\n";
+
+  // ---- BENCHMARK 2: RANDOM READ ----
+  std::cout << "--- Random Read ---\n";
+
+  t1 = std::chrono::high_resolution_clock::now();
+  acc = 0;
+  for (int i = 0; i < NUM_RANDOM; ++i) {
+    int cell = rnd_cell[i];
+    acc += static_cast<int>(
+        byte_chunks[rnd_chunk[i]][cell / CHUNK_SIZE][cell % CHUNK_SIZE]);
+  }
+  sink = acc;
+  t2 = std::chrono::high_resolution_clock::now();
+  auto byte_rnd =
+      std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count();
+
+  t1 = std::chrono::high_resolution_clock::now();
+  acc = 0;
+  for (int i = 0; i < NUM_RANDOM; ++i) {
+    acc += static_cast<int>(packed_chunks[rnd_chunk[i]].get(rnd_cell[i]));
+  }
+  sink = acc;
+  t2 = std::chrono::high_resolution_clock::now();
+  auto packed_rnd =
+      std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count();
+
+  double rnd_ratio =
+      static_cast<double>(byte_rnd) / static_cast<double>(packed_rnd);
+  std::cout << "  byte array:    " << byte_rnd << " us\n";
+  std::cout << "  PackedBlocks:  " << packed_rnd << " us\n";
+  std::cout << "  Speedup:       " << rnd_ratio << "x\n\n";
+
+  // ---- BENCHMARK 3: RANDOM WRITE ----
+  std::cout << "--- Random Write ---\n";
+
+  t1 = std::chrono::high_resolution_clock::now();
+  for (int i = 0; i < NUM_RANDOM; ++i) {
+    int cell = rnd_cell[i];
+    byte_chunks[rnd_chunk[i]][cell / CHUNK_SIZE][cell % CHUNK_SIZE] =
+        static_cast<BlockType>(i & 7);
+  }
+  t2 = std::chrono::high_resolution_clock::now();
+  auto byte_wr =
+      std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count();
+
+  t1 = std::chrono::high_resolution_clock::now();
+  for (int i = 0; i < NUM_RANDOM; ++i) {
+    packed_chunks[rnd_chunk[i]].set(rnd_cell[i], static_cast<BlockType>(i & 7));
+  }
+  t2 = std::chrono::high_resolution_clock::now();
+  auto packed_wr =
+      std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count();
+
+  sink = static_cast<int>(byte_chunks[0][0][0]) +
+         static_cast<int>(packed_chunks[0].get(0));
+
+  double wr_ratio =
+      static_cast<double>(byte_wr) / static_cast<double>(packed_wr);
+  std::cout << "  byte array:    " << byte_wr << " us\n";
+  std::cout << "  PackedBlocks:  " << packed_wr << " us\n";
+  std::cout << "  Speedup:       " << wr_ratio << "x\n\n";
+
+  // ---- SUMMARY ----
+  std::cout << "========================================\n";
+  std::cout << "   SUMMARY\n";
+  std::cout << "   Memory saved:        "
+            << (1.0 - static_cast<double>(packed_mem) /
+                          static_cast<double>(byte_mem)) *
+                   100.0
+            << "%\n";
+  std::cout << "   Sequential speedup:  " << seq_ratio << "x\n";
+  std::cout << "   Random read speedup: " << rnd_ratio << "x\n";
+  std::cout << "   Random write speedup:" << wr_ratio << "x\n";
+  std::cout << "========================================\n\n";
+
+  (void)sink;
+}
+
+// ============================================================================
+//  Chunk Pool Benchmark: make_unique<Chunk> per chunk vs ChunkPool
+// ============================================================================
+//
+//  Simulates repeated clear() + load cycles: every cycle drops all chunks
+//  and installs NUM_CHUNKS again. The first cycle is cold (slabs / heap
+//  blocks get allocated); later cycles show free-list reuse. Finishes with
+//  a real save_game/load_game round trip through World.
+//
+//  The pool runs first and its World stays alive, so the make_unique run
+//  can't recycle pool memory; each side's RSS is the growth of current
+//  RSS over its own run. Building the Chunk (payload copy, solidity rows)
+//  costs far more than either allocator, so the two land within run-to-run
+//  noise of each other; the pool's win is cache-line slots, not load time.
+//
+// ============================================================================
+
+inline void run_chunk_pool_benchmark() {
+  const int NUM_CHUNKS = 20000;
+  const int NUM_CYCLES = 5;
+
+  std::cout << "\n========================================\n";
+  std::cout << "   CHUNK POOL BENCHMARK\n";
+  std::cout << "   make_unique<Chunk> vs ChunkPool\n";
+  std::cout << "   " << NUM_CHUNKS << " chunks x " << NUM_CYCLES
+            << " load cycles\n";
+  std::cout << "========================================\n\n";
+
+  // A handful of distinct chunk payloads, as a loader would read them
+  std::vector<PackedBlocks> payloads(16);
+  for (int i = 0; i < 16; ++i) {
+    std::array<std::array<BlockType, CHUNK_SIZE>, CHUNK_SIZE> grid;
+    generate_chunk_terrain(grid, i);
+    payloads[i].assign(grid);
+  }
+
+  // ---- ChunkPool via World::load_chunk ----
+  long long pool_cold = 0, pool_warm = 0;
+  size_t rss_mark = current_rss_kb();
+  World world;
+  for (int cycle = 0; cycle < NUM_CYCLES; ++cycle) {
+    world.clear();
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < NUM_CHUNKS; ++i) {
+      world.load_chunk({i, 0}, payloads[i & 15]);
+    }
+    auto t2 = std::chrono::high_resolution_clock::now();
+    auto us =
+        std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count();
+    if (cycle == 0)
+      pool_cold = us;
+    else
+      pool_warm += us;
+  }
+  pool_warm /= (NUM_CYCLES - 1);
+  size_t rss_now = current_rss_kb();
+  size_t pool_rss = rss_now > rss_mark ? rss_now - rss_mark : 0;
+
+  // ---- make_unique per chunk (pre-pool World layout) ----
+  long long heap_cold = 0, heap_warm = 0;
+  size_t heap_rss = 0;
+  rss_mark = current_rss_kb();
+  {
+    RobinHoodMap<Coord, std::unique_ptr<Chunk>, CoordHash> map;
+    for (int cycle = 0; cycle < NUM_CYCLES; ++cycle) {
+      map.clear();
+      auto t1 = std::chrono::high_resolution_clock::now();
+      for (int i = 0; i < NUM_CHUNKS; ++i) {
+        Coord pos = {i, 0};
+        map[pos] = std::make_unique<Chunk>(pos, payloads[i & 15]);
+      }
+      auto t2 = std::chrono::high_resolution_clock::now();
+      auto us =
+          std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1)
+              .count();
+      if (cycle == 0)
+        heap_cold = us;
+      else
+        heap_warm += us;
+    }
+    rss_now = current_rss_kb();
+    heap_rss = rss_now > rss_mark ? rss_now - rss_mark : 0;
+  }
+  heap_warm /= (NUM_CYCLES - 1);
+
+  std::cout << "--- make_unique<Chunk> ---\n";
+  std::cout << "  Cold cycle:    " << heap_cold << " us\n";
+  std::cout << "  Warm cycle:    " << heap_warm << " us\n";
+  std::cout << "  Allocations:   " << NUM_CHUNKS << " per cycle\n";
+  std::cout << "  RSS growth:    " << heap_rss << " KB\n\n";
+
+  std::cout << "--- ChunkPool ---\n";
+  std::cout << "  Cold cycle:    " << pool_cold << " us\n";
+  std::cout << "  Warm cycle:    " << pool_warm << " us\n";
+  std::cout << "  Allocations:   "
+            << (NUM_CHUNKS + ChunkPool::SLAB_CHUNKS - 1) /
+                   ChunkPool::SLAB_CHUNKS
+            << " slabs, then 0\n";
+  std::cout << "  RSS growth:    " << pool_rss << " KB\n";
+  std::cout << "  Pool size:     " << world.pool_bytes() / 1024 << " KB ("
+            << ChunkPool::SLOT_BYTES << " B/slot)\n\n";
+
+  // ---- real load_game through the pool ----
+  std::cout << "--- load_game (" << NUM_CHUNKS << " chunks) ---\n";
+  const std::string path = "pool_bench.mc2d";
+  int px = 0, py = 0, hp = 100, facing = 1, sel = 1;
+  int inv[9] = {0};
+  MobStorage mobs;
+  long long load_us[2] = {0, 0};
+  if (save_game(path, world, px, py, hp, facing, sel, inv, mobs)) {
+    for (int run = 0; run < 2; ++run) {
+      auto t1 = std::chrono::high_resolution_clock::now();
+      load_game(path, world, px, py, hp, facing, sel, inv, mobs);
+      auto t2 = std::chrono::high_resolution_clock::now();
+      load_us[run] =
+          std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1)
+              .count();
+    }
+    std::remove(path.c_str());
+  }
+  std::cout << "  First load:    " << load_us[0] << " us\n";
+  std::cout << "  Reload:        " << load_us[1] << " us\n\n";
+
+  std::cout << "========================================\n";
+  std::cout << "   SUMMARY\n";
+  std::cout << "   Cold load speedup:   "
+            << static_cast<double>(heap_cold) / static_cast<double>(pool_cold)
+            << "x\n";
+  std::cout << "   Warm load speedup:   "
+            << static_cast<double>(heap_warm) / static_cast<double>(pool_warm)
+            << "x\n";
+  std::cout << "   RSS growth:          " << heap_rss << " KB -> " << pool_rss
+            << " KB\n";
+  std::cout << "========================================\n\n";
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include "Chunk.h"
+#include "Coord.h"
+#include "PackedBlocks.h"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// ============================================================================
+//  ChunkGenerator — Background Terrain Generation
+// ============================================================================
+//
+//  One worker thread runs generate_chunk_blocks for requested chunk coords.
+//  The main thread submits coords with request() and picks up finished
+//  chunks with collect(); the worker never touches World.
+//
+//  Requests are served newest-first: when the player turns around or
+//  sprints, the chunks asked for last are the ones about to be on screen.
+//
+// ============================================================================
+
+class ChunkGenerator {
+  std::mutex mu_;
+  std::condition_variable cv_;
+  std::deque<Coord> requests_;
+  std::vector<std::pair<Coord, PackedBlocks>> done_;
+  bool stop_ = false;
+  std::thread worker_;
+
+  void run() {
+    std::unique_lock<std::mutex> lock(mu_);
+    while (true) {
+      cv_.wait(lock, [this] { return stop_ || !requests_.empty(); });
+      if (stop_)
+        return;
+      Coord pos = requests_.back();
+      requests_.pop_back();
+
+      lock.unlock();
+      PackedBlocks blocks = generate_chunk_blocks(pos);
+      lock.lock();
+
+      done_.emplace_back(pos, std::move(blocks));
+    }
+  }
+
+public:
+  ChunkGenerator() : worker_([this] { run(); }) {}
+
+  ~ChunkGenerator() {
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+      stop_ = true;
+    }
+    cv_.notify_one();
+    worker_.join();
+  }
+
+  ChunkGenerator(const ChunkGenerator &) = delete;
+  ChunkGenerator &operator=(const ChunkGenerator &) = delete;
+
+  void request(Coord pos) {
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+      requests_.push_back(pos);
+    }
+    cv_.notify_one();
+  }
+
+  // Hand every finished chunk to fn(Coord, PackedBlocks&&) on this thread
+  template <typename Fn> void collect(Fn &&fn) {
+    std::vector<std::pair<Coord, PackedBlocks>> ready;
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+      ready.swap(done_);
+    }
+    for (auto &[pos, blocks] : ready) {
+      fn(pos, std::move(blocks));
+    }
+  }
+};
@@ -0,0 +1,123 @@
+#pragma once
+#include "Chunk.h"
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+// ============================================================================
+//  ChunkPool — Slab Allocator for Chunk Objects
+// ============================================================================
+//
+//  1. Chunks are carved out of large slabs (SLAB_CHUNKS per allocation)
+//     instead of one heap allocation each
+//  2. Every slot starts on a cache line and is padded to whole lines, so
+//     neighbouring chunks never share a line
+//  3. Destroyed chunks go on an intrusive free list that create() reuses
+//     first, so a World::clear() + load_game cycle recycles the same memory
+//  4. Chunks never move once created — Chunk& stays valid until destroy()
+//
+// ============================================================================
+
+class ChunkPool {
+public:
+  static constexpr size_t CACHE_LINE = 64;
+  static constexpr size_t SLAB_CHUNKS = 64;
+  static constexpr size_t SLOT_BYTES =
+      (sizeof(Chunk) + CACHE_LINE - 1) & ~(CACHE_LINE - 1);
+
+private:
+  struct FreeNode {
+    FreeNode *next;
+  };
+
+  std::vector<void *> slabs_;
+  FreeNode *free_ = nullptr;
+  size_t live_ = 0;
+
+  void add_slab() {
+    char *mem = static_cast<char *>(::operator new(
+        SLAB_CHUNKS * SLOT_BYTES, std::align_val_t{CACHE_LINE}));
+    slabs_.push_back(mem);
+    // Push in reverse so create() hands out ascending addresses
+    for (size_t i = SLAB_CHUNKS; i-- > 0;) {
+      auto *node = reinterpret_cast<FreeNode *>(mem + i * SLOT_BYTES);
+      node->next = free_;
+      free_ = node;
+    }
+  }
+
+  void release_slabs() {
+    for (void *s : slabs_) {
+      ::operator delete(s, std::align_val_t{CACHE_LINE});
+    }
+    slabs_.clear();
+    free_ = nullptr;
+  }
+
+public:
+  ChunkPool() = default;
+
+  // Every chunk must be destroy()ed before the pool goes away
+  ~ChunkPool() { release_slabs(); }
+
+  ChunkPool(ChunkPool &&o) noexcept
+      : slabs_(std::move(o.slabs_)), free_(o.free_), live_(o.live_) {
+    o.slabs_.clear();
+    o.free_ = nullptr;
+    o.live_ = 0;
+  }
+
+  ChunkPool &operator=(ChunkPool &&o) noexcept {
+    if (this != &o) {
+      release_slabs();
+      slabs_ = std::move(o.slabs_);
+      free_ = o.free_;
+      live_ = o.live_;
+      o.slabs_.clear();
+      o.free_ = nullptr;
+      o.live_ = 0;
+    }
+    return *this;
+  }
+
+  ChunkPool(const ChunkPool &) = delete;
+  ChunkPool &operator=(const ChunkPool &) = delete;
+
+  template <typename... Args> Chunk *create(Args &&...args) {
+    if (!free_)
+      add_slab();
+    FreeNode *node = free_;
+    free_ = node->next;
+    try {
+      Chunk *c = new (node) Chunk(std::forward<Args>(args)...);
+      ++live_;
+      return c;
+    } catch (...) {
+      node->next = free_;
+      free_ = node;
+      throw;
+    }
+  }
+
+  void destroy(Chunk *c) {
+    c->~Chunk();
+    auto *node = reinterpret_cast<FreeNode *>(c);
+    node->next = free_;
+    free_ = node;
+    --live_;
+  }
+
+  // Grow so that n chunks fit without another slab allocation
+  void reserve(size_t n) {
+    while (capacity() < n) {
+      add_slab();
+    }
+  }
+
+  size_t live() const { return live_; }
+  size_t capacity() const { return slabs_.size() * SLAB_CHUNKS; }
+  size_t reserved_bytes() const {
+    return slabs_.size() * SLAB_CHUNKS * SLOT_BYTES;
+  }
+};
@@ -0,0 +1,148 @@
+#pragma once
+#include "Coord.h"
+#include "PackedBlocks.h"
+#include "RobinHoodMap.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+// ============================================================================
+//  ChunkStore — On-Disk Spill File for Evicted Chunks
+// ============================================================================
+//
+//  Append-only file of PackedBlocks records plus an in-memory index
+//  Coord -> file offset. put() appends, take() reads a record back and
+//  forgets it. Dead records are reclaimed by compacting the file once they
+//  outnumber the live ones, so long sessions don't grow it without bound.
+//
+//  The file is scratch space: truncated on open and removed on destruction.
+//  scratch_path() names one no other store in any process is using.
+//
+// ============================================================================
+
+class ChunkStore {
+  std::string path_;
+  std::fstream file_;
+  RobinHoodMap<Coord, uint64_t, CoordHash> index_;
+  uint64_t end_ = 0;     // append offset
+  size_t dead_ = 0;      // records no longer referenced by index_
+
+  bool read_at(uint64_t off, PackedBlocks &out) {
+    file_.clear();
+    file_.seekg(static_cast<std::streamoff>(off));
+    return read_packed_blocks(file_, out);
+  }
+
+  // Rewrite the file with only the live records
+  void compact() {
+    std::vector<std::pair<Coord, PackedBlocks>> live;
+    live.reserve(index_.size());
+    for (auto [pos, off] : index_) {
+      PackedBlocks pb;
+      if (read_at(off, pb))
+        live.emplace_back(pos, std::move(pb));
+    }
+    reopen();
+    for (auto &[pos, pb] : live) {
+      put(pos, pb);
+    }
+  }
+
+  void reopen() {
+    file_.close();
+    file_.open(path_, std::ios::in | std::ios::out | std::ios::binary |
+                          std::ios::trunc);
+    index_.clear();
+    end_ = 0;
+    dead_ = 0;
+  }
+
+public:
+  explicit ChunkStore(std::string path) : path_(std::move(path)) { reopen(); }
+
+  // A fresh file in the temp directory, unique per process and per call
+  static std::string scratch_path() {
+    static std::atomic<uint64_t> next{0};
+#ifdef _WIN32
+    long long pid = _getpid();
+#else
+    long long pid = getpid();
+#endif
+    std::error_code ec;
+    std::filesystem::path dir = std::filesystem::temp_directory_path(ec);
+    if (ec)
+      dir = ".";
+    std::string name = "cachecraft_spill_" + std::to_string(pid) + "_" +
+                       std::to_string(next.fetch_add(1)) + ".tmp";
+    return (dir / name).string();
+  }
+
+  ~ChunkStore() {
+    file_.close();
+    std::remove(path_.c_str());
+  }
+
+  ChunkStore(const ChunkStore &) = delete;
+  ChunkStore &operator=(const ChunkStore &) = delete;
+
+  bool good() const { return file_.is_open(); }
+
+  bool put(Coord pos, const PackedBlocks &pb) {
+    if (!file_.is_open())
+      return false;
+    file_.clear();
+    file_.seekp(static_cast<std::streamoff>(end_));
+    write_packed_blocks(file_, pb);
+    if (!file_)
+      return false;
+
+    if (!index_.insert_or_assign(pos, end_).second)
+      ++dead_; // replaced an older record
+    end_ = static_cast<uint64_t>(file_.tellp());
+    return true;
+  }
+
+  // Read the record for pos into out and drop it from the store
+  bool take(Coord pos, PackedBlocks &out) {
+    auto it = index_.find(pos);
+    if (it == index_.end())
+      return false;
+    auto [key, off] = *it;
+    bool ok = read_at(off, out);
+    index_.erase(pos);
+    ++dead_;
+    if (dead_ > 256 && dead_ > index_.size())
+      compact();
+    return ok;
+  }
+
+  void erase(Coord pos) {
+    if (index_.erase(pos))
+      ++dead_;
+  }
+
+  bool contains(Coord pos) const { return index_.count(pos) != 0; }
+  size_t size() const { return index_.size(); }
+  uint64_t file_bytes() const { return end_; }
+
+  template <typename Fn> void for_each(Fn &&fn) {
+    for (auto [pos, off] : index_) {
+      PackedBlocks pb;
+      if (read_at(off, pb))
+        fn(pos, pb);
+    }
+  }
+
+  void clear() { reopen(); }
+};
@@ -0,0 +1,333 @@
+#pragma once
+#include "RobinHoodMap.h"
+#include <array>
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// ============================================================================
+//  ConcurrentRobinHoodMap — Sharded RobinHoodMap for Multi-Threaded Access
+// ============================================================================
+//
+//  SHARDS independent RobinHoodMaps. A key's shard comes from the top bits
+//  of its mixed hash; the shard's own table indexes with the low bits, so
+//  the two choices don't correlate. Writers to different shards don't
+//  contend; writers to one shard take its lock.
+//
+//  Reads of trivially copyable K and V take no lock. Each shard keeps a
+//  version (seqlock) that is odd while a write is in progress: a reader
+//  notes an even version, probes the live table, copies the value out and
+//  keeps the copy only if the version hasn't moved; otherwise it retries.
+//
+//  What makes the unlocked probe safe is that no table a reader can reach
+//  is ever freed or reallocated under it:
+//
+//  1. A write that would grow the live table builds a bigger one instead,
+//     applies the write there and publishes it with one pointer store
+//  2. Replaced tables are retired, not freed, until the map is destroyed.
+//     Each is at most half the size of the one after it, so together they
+//     never hold more than the live table does
+//
+//  Other value types (unique_ptr, strings) can't be copied out blind and
+//  re-validated, so their reads share the shard's lock as before; so does
+//  every read in a ROBINHOOD_STATS build, where probes bump counters.
+//
+//  Values are never handed out by reference. Reads go through visit() (fn
+//  gets a validated copy, or runs under the shared lock), get() (copy,
+//  copyable V only) or take() (move out and erase).
+//
+// ============================================================================
+
+template <typename K, typename V, typename Hash = std::hash<K>,
+          typename KeyEqual = std::equal_to<K>, size_t SHARDS = 16>
+class ConcurrentRobinHoodMap {
+  static_assert(SHARDS > 0 && (SHARDS & (SHARDS - 1)) == 0,
+                "SHARDS must be a power of two");
+
+  using Map = RobinHoodMap<K, V, Hash, KeyEqual>;
+
+  static constexpr bool LOCK_FREE_READS = std::is_trivially_copyable_v<K> &&
+                                          std::is_trivially_copyable_v<V> &&
+                                          !RobinHoodStats::enabled;
+
+  // Each shard starts its own cache line, so neighbouring locks don't
+  // false-share
+  struct alignas(64) Shard {
+    mutable std::shared_mutex mu; // writers; locked readers
+    std::atomic<uint64_t> version{0}; // odd while a write is in progress
+    std::atomic<Map *> live;
+    std::vector<std::unique_ptr<Map>> tables; // back() is live
+
+    Shard() : tables(1) {
+      tables[0] = std::make_unique<Map>();
+      live.store(tables[0].get(), std::memory_order_relaxed);
+    }
+  };
+
+  std::array<Shard, SHARDS> shards_;
+  Hash hasher_;
+
+  // A ROBINHOOD_STATS build bumps counters on every probe, so readers of
+  // one shard can't share it there
+#ifdef ROBINHOOD_STATS
+  using ReadLock = std::unique_lock<std::shared_mutex>;
+#else
+  using ReadLock = std::shared_lock<std::shared_mutex>;
+#endif
+
+  Shard &shard_of(const K &key) {
+    return shards_[shard_index(robinhood_hash(hasher_, key))];
+  }
+  const Shard &shard_of(const K &key) const {
+    return shards_[shard_index(robinhood_hash(hasher_, key))];
+  }
+
+  static size_t shard_index(size_t h) {
+    if constexpr (SHARDS == 1)
+      return 0;
+    else
+      return h >> (sizeof(size_t) * 8 - std::countr_zero(SHARDS));
+  }
+
+  // ---------------------------------------------------------------
+  //  Write side — always under the shard's exclusive lock
+  // ---------------------------------------------------------------
+
+  // fn(live table) as one write: the version is odd while it runs, so
+  // unlocked readers that overlap it retry
+  template <typename Fn> static decltype(auto) write(Shard &s, Fn &&fn) {
+    struct Bump {
+      std::atomic<uint64_t> &v;
+      explicit Bump(std::atomic<uint64_t> &ver) : v(ver) {
+        v.store(v.load(std::memory_order_relaxed) + 1,
+                std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+      }
+      ~Bump() {
+        v.store(v.load(std::memory_order_relaxed) + 1,
+                std::memory_order_release);
+      }
+    } bump(s.version);
+    return fn(*s.tables.back());
+  }
+
+  // fn(table) for a write that may insert key. If that would grow the
+  // live table, the entries move to a bigger one first and fn runs there
+  // before anyone can see it; readers still on the old one find it intact.
+  template <typename Fn>
+  static decltype(auto) write_inserting(Shard &s, const K &key, Fn &&fn) {
+    Map &cur = *s.tables.back();
+    if (!cur.insert_grows(key))
+      return write(s, fn);
+
+    auto next = std::make_unique<Map>();
+    next->reserve(cur.capacity()); // twice the slots
+    for (auto it = cur.begin(); it != cur.end(); ++it) {
+      auto [k, v] = *it;
+      // A copy for lock-free V; locked readers can't see the move
+      next->try_emplace(k, std::move(v));
+    }
+    decltype(auto) result = fn(*next);
+    s.live.store(next.get(), std::memory_order_release);
+    s.tables.push_back(std::move(next));
+    return result;
+  }
+
+  // ---------------------------------------------------------------
+  //  Read side
+  // ---------------------------------------------------------------
+
+  // fn(table) until it ran without a write overlapping it. fn may see a
+  // half-written table and must only copy data out; what it copied on the
+  // last call is consistent.
+  template <typename Fn> static void read_optimistic(const Shard &s, Fn &&fn) {
+    for (;;) {
+      uint64_t before = s.version.load(std::memory_order_acquire);
+      if (before & 1) {
+        std::this_thread::yield();
+        continue;
+      }
+      fn(*s.live.load(std::memory_order_acquire));
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (s.version.load(std::memory_order_relaxed) == before)
+        return;
+    }
+  }
+
+public:
+  ConcurrentRobinHoodMap() = default;
+  ConcurrentRobinHoodMap(const ConcurrentRobinHoodMap &) = delete;
+  ConcurrentRobinHoodMap &operator=(const ConcurrentRobinHoodMap &) = delete;
+
+  // True when reads take no lock (trivially copyable K and V)
+  static constexpr bool lock_free_reads() { return LOCK_FREE_READS; }
+
+  // ---------------------------------------------------------------
+  //  Writers — exclusive lock on one shard
+  // ---------------------------------------------------------------
+
+  // Construct V from args if key is absent. True if inserted.
+  template <typename... Args> bool try_emplace(const K &key, Args &&...args) {
+    Shard &s = shard_of(key);
+    std::unique_lock lock(s.mu);
+    return write_inserting(s, key, [&](Map &m) {
+      return m.try_emplace(key, std::forward<Args>(args)...).second;
+    });
+  }
+
+  // True if inserted, false if an existing value was replaced
+  template <typename M> bool insert_or_assign(const K &key, M &&obj) {
+    Shard &s = shard_of(key);
+    std::unique_lock lock(s.mu);
+    return write_inserting(s, key, [&](Map &m) {
+      return m.insert_or_assign(key, std::forward<M>(obj)).second;
+    });
+  }
+
+  bool erase(const K &key) {
+    Shard &s = shard_of(key);
+    std::unique_lock lock(s.mu);
+    return write(s, [&](Map &m) { return m.erase(key); });
+  }
+
+  // Move the value out and erase the entry
+  std::optional<V> take(const K &key) {
+    Shard &s = shard_of(key);
+    std::unique_lock lock(s.mu);
+    return write(s, [&](Map &m) -> std::optional<V> {
+      auto it = m.find(key);
+      if (it == m.end())
+        return std::nullopt;
+      std::optional<V> out(std::move((*it).second));
+      m.erase(key);
+      return out;
+    });
+  }
+
+  // fn(V&) under the exclusive lock. False if key is absent.
+  template <typename Fn> bool modify(const K &key, Fn &&fn) {
+    Shard &s = shard_of(key);
+    std::unique_lock lock(s.mu);
+    return write(s, [&](Map &m) {
+      auto it = m.find(key);
+      if (it == m.end())
+        return false;
+      fn((*it).second);
+      return true;
+    });
+  }
+
+  // ---------------------------------------------------------------
+  //  Readers — unlocked for trivially copyable K and V, otherwise a
+  //  shared lock on one shard
+  // ---------------------------------------------------------------
+
+  // fn(const V&) on the value, or on a validated copy of it when reads
+  // are lock-free. False if key is absent.
+  template <typename Fn> bool visit(const K &key, Fn &&fn) const {
+    const Shard &s = shard_of(key);
+    if constexpr (LOCK_FREE_READS) {
+      union Copy {
+        char none;
+        V value;
+      } copy{};
+      bool found = false;
+      read_optimistic(s, [&](const Map &m) {
+        auto it = m.find(key);
+        found = it != m.end();
+        if (found)
+          std::memcpy(&copy.value, &(*it).second, sizeof(V));
+      });
+      if (found)
+        fn(static_cast<const V &>(copy.value));
+      return found;
+    } else {
+      ReadLock lock(s.mu);
+      auto it = s.tables.back()->find(key);
+      if (it == s.tables.back()->end())
+        return false;
+      fn((*it).second);
+      return true;
+    }
+  }
+
+  std::optional<V> get(const K &key) const
+    requires std::copy_constructible<V>
+  {
+    std::optional<V> out;
+    visit(key, [&](const V &v) { out.emplace(v); });
+    return out;
+  }
+
+  bool contains(const K &key) const {
+    const Shard &s = shard_of(key);
+    if constexpr (LOCK_FREE_READS) {
+      bool found = false;
+      read_optimistic(s, [&](const Map &m) { found = m.count(key) != 0; });
+      return found;
+    } else {
+      ReadLock lock(s.mu);
+      return s.tables.back()->count(key) != 0;
+    }
+  }
+
+  // ---------------------------------------------------------------
+  //  Whole-map operations — one shard at a time, so under concurrent
+  //  writers the result is a mix of moments, not a snapshot
+  // ---------------------------------------------------------------
+  size_t size() const {
+    size_t n = 0;
+    for (const Shard &s : shards_) {
+      std::shared_lock lock(s.mu);
+      n += s.tables.back()->size();
+    }
+    return n;
+  }
+
+  // fn(const K&, const V&) for every entry, each shard under its shared lock
+  template <typename Fn> void for_each(Fn &&fn) const {
+    for (const Shard &s : shards_) {
+      std::shared_lock lock(s.mu);
+      for (auto [k, v] : *s.tables.back())
+        fn(k, v);
+    }
+  }
+
+  // Empties every shard; retired tables stay until the map is destroyed,
+  // since a lock-free reader may still be walking one
+  void clear() {
+    for (Shard &s : shards_) {
+      std::unique_lock lock(s.mu);
+      write(s, [](Map &m) { m.clear(); });
+    }
+  }
+
+  // Slots held by replaced tables, kept for readers that may still use them
+  size_t retired_capacity() const {
+    size_t n = 0;
+    for (const Shard &s : shards_) {
+      std::shared_lock lock(s.mu);
+      for (size_t i = 0; i + 1 < s.tables.size(); ++i)
+        n += s.tables[i]->capacity();
+    }
+    return n;
+  }
+
+  size_t shard_size(size_t i) const {
+    std::shared_lock lock(shards_[i].mu);
+    return shards_[i].tables.back()->size();
+  }
+
+  static constexpr size_t shard_count() { return SHARDS; }
+};
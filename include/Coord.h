@@ -1,6 +1,6 @@
 #pragma once
 #include <cstddef>
-#include <functional>
+#include <cstdint>
 #include <iostream>
 
 struct Coord {
@@ -25,10 +25,21 @@ inline std::ostream &operator<<(std::ostream &os, const Coord &coord) {
   return os;
 }
 
+// Packs (x, y) into one 64-bit key and runs it through the murmur3 fmix64
+// finalizer, so every input bit reaches the low bits that pick a bucket.
+// Neighbouring coords (chunk rows, BFS frontiers, multiples of CHUNK_SIZE)
+// land in unrelated slots instead of one long probe run.
 struct CoordHash {
+  using is_avalanching = void; // RobinHoodMap needn't mix it again
+
   size_t operator()(const Coord &c) const {
-    size_t h1 = std::hash<int>{}(c.x);
-    size_t h2 = std::hash<int>{}(c.y);
-    return h1 ^ (h2 * 2654435761u);
+    uint64_t k = (static_cast<uint64_t>(static_cast<uint32_t>(c.x)) << 32) |
+                 static_cast<uint32_t>(c.y);
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+    return static_cast<size_t>(k);
   }
 };
\ No newline at end of file
@@ -0,0 +1,174 @@
+#pragma once
+#include "Coord.h"
+#include "Pathfinding.h"
+#include "World.h"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+// ============================================================================
+//  FlowField — One Reverse BFS from the Player, Shared by Every Mob
+// ============================================================================
+//
+//  Instead of one bfs_findpath per mob per tick, build() searches once
+//  backwards from the target over a square window around it: a cell u is
+//  reached from an already-reached v when can_step(u, v - u) holds, so
+//  every reached cell stores its BFS distance to the target and the move
+//  that starts a shortest path there. A mob then steps with next_step(),
+//  one array read.
+//
+//  Solidity is read only where the search goes: is_air is asked about a
+//  cell the first time a rule needs it and the answer kept in a window
+//  snapshot (one extra cell of border, since the rules look beside and
+//  under a cell). On rough terrain the search reaches a few hundred of the
+//  window's 35k cells, so a build costs about what it reaches: the next
+//  build resets only the distances and snapshot cells the last one wrote.
+//  Cells outside the window count as unreachable; a mob there gets no
+//  step, as a failed bfs_findpath would.
+//
+//  A single search still costs more than a handful of bfs_findpath calls
+//  that mostly fail at may_reach, so GameWindow only builds a field when
+//  at least FIELD_MIN_MOBS mobs replan in the same tick.
+//
+//  A shortest path from the field is as short as bfs_search's but may pick
+//  a different one among equals.
+//
+// ============================================================================
+
+class FlowField {
+  static constexpr uint16_t UNREACHED = 0xFFFF;
+  enum : uint8_t { UNKNOWN, AIR, SOLID }; // air_ states
+
+  Coord target_;
+  Coord origin_;   // world coord of window cell (0, 0)
+  int size_ = 0;   // window is size_ x size_ cells
+  size_t reached_ = 0;
+
+  std::vector<uint8_t> air_;    // (size_ + 2)^2 snapshot, filled on demand
+  std::vector<uint32_t> known_; // air_ cells the last build filled
+  std::vector<uint16_t> dist_;  // steps to target, UNREACHED if none
+  std::vector<uint8_t> move_;   // PATH_DIRS index of the first step
+  std::vector<uint32_t> queue_; // cells the last build reached, in order
+
+  // Window cell index of world (x, y), or -1 outside
+  int cell_of(int wx, int wy) const {
+    unsigned x = static_cast<unsigned>(wx - origin_.x);
+    unsigned y = static_cast<unsigned>(wy - origin_.y);
+    unsigned n = static_cast<unsigned>(size_);
+    if (x >= n || y >= n)
+      return -1;
+    return static_cast<int>(y) * size_ + static_cast<int>(x);
+  }
+
+  template <typename IsAir>
+  bool snapshot_air(int wx, int wy, IsAir &is_air) {
+    int stride = size_ + 2;
+    int x = wx - origin_.x + 1;
+    int y = wy - origin_.y + 1;
+    size_t i = static_cast<size_t>(y) * stride + x;
+    if (air_[i] == UNKNOWN) {
+      air_[i] = is_air(wx, wy) ? AIR : SOLID;
+      known_.push_back(static_cast<uint32_t>(i));
+    }
+    return air_[i] == AIR;
+  }
+
+  // Make every cell unreached and unknown again: all of them if the window
+  // size changed, otherwise only those the last build touched
+  void reset(int size) {
+    size_t cells = static_cast<size_t>(size) * size;
+    size_t stride = static_cast<size_t>(size) + 2;
+    if (size != size_) {
+      dist_.assign(cells, UNREACHED);
+      move_.resize(cells);
+      air_.assign(stride * stride, UNKNOWN);
+    } else {
+      for (uint32_t c : queue_)
+        dist_[c] = UNREACHED;
+      for (uint32_t c : known_)
+        air_[c] = UNKNOWN;
+    }
+    size_ = size;
+    queue_.clear();
+    known_.clear();
+  }
+
+public:
+  static constexpr int DEFAULT_RADIUS = 92;
+  static constexpr int DEFAULT_MAX_DEPTH = 150;
+
+  // Search the (2 * radius + 1)^2 window centred on target, out to
+  // max_depth steps. is_air(x, y) is asked at most once per cell, and
+  // only about cells the search's rules look at.
+  template <typename IsAir>
+  void build(Coord target, IsAir &&is_air, int radius = DEFAULT_RADIUS,
+             int max_depth = DEFAULT_MAX_DEPTH) {
+    reset(2 * radius + 1);
+    target_ = target;
+    origin_ = {target.x - radius, target.y - radius};
+    auto snap = [&](int x, int y) { return snapshot_air(x, y, is_air); };
+
+    int t = cell_of(target.x, target.y);
+    dist_[t] = 0;
+    queue_.push_back(static_cast<uint32_t>(t));
+    for (size_t head = 0; head < queue_.size(); ++head) {
+      uint32_t v = queue_[head];
+      uint16_t d = dist_[v];
+      if (d >= max_depth)
+        break; // FIFO order: everything after is at least as deep
+      Coord vp = {origin_.x + static_cast<int>(v) % size_,
+                  origin_.y + static_cast<int>(v) / size_};
+      for (uint8_t m = 0; m < 8; ++m) {
+        Coord up = vp - PATH_DIRS[m];
+        int u = cell_of(up.x, up.y);
+        if (u < 0 || dist_[u] != UNREACHED ||
+            !can_step(up, PATH_DIRS[m], snap))
+          continue;
+        dist_[u] = static_cast<uint16_t>(d + 1);
+        move_[u] = m;
+        queue_.push_back(static_cast<uint32_t>(u));
+      }
+    }
+    reached_ = queue_.size();
+  }
+
+  // Next cell on a shortest path from pos to the target; nullopt at the
+  // target itself, outside the window or where the target is unreachable
+  std::optional<Coord> next_step(Coord pos) const {
+    std::optional<uint8_t> m = next_move(pos);
+    if (!m)
+      return std::nullopt;
+    return pos + PATH_DIRS[*m];
+  }
+
+  // next_step as its PATH_DIRS index
+  std::optional<uint8_t> next_move(Coord pos) const {
+    int c = size_ ? cell_of(pos.x, pos.y) : -1;
+    if (c < 0 || dist_[c] == UNREACHED || dist_[c] == 0)
+      return std::nullopt;
+    return move_[c];
+  }
+
+  // Steps from pos to the target, or -1 if unreached
+  int distance(Coord pos) const {
+    int c = size_ ? cell_of(pos.x, pos.y) : -1;
+    if (c < 0 || dist_[c] == UNREACHED)
+      return -1;
+    return dist_[c];
+  }
+
+  Coord target() const { return target_; }
+  size_t reached_count() const { return reached_; }
+};
+
+// Field toward target over the loaded world, with bfs_findpath's view of
+// it: chunks that aren't loaded count as solid and are never generated
+inline void build_flow_field(FlowField &field, Coord target, World &world,
+                             int radius = FlowField::DEFAULT_RADIUS,
+                             int max_depth = FlowField::DEFAULT_MAX_DEPTH) {
+  World::Cursor cursor(world);
+  field.build(
+      target, [&](int x, int y) { return cursor.try_is_air(x, y) == true; },
+      radius, max_depth);
+}
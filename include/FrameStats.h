@@ -0,0 +1,40 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+// Rolling window of per-frame work times (input + update + render, no sleep).
+// Spikes are frames over SPIKE_MS; they are what a generation stall looks
+// like from the player's seat.
+struct FrameStats {
+  static constexpr size_t WINDOW = 120;
+  static constexpr float SPIKE_MS = 4.0f;
+
+  std::array<float, WINDOW> samples{};
+  size_t next = 0;
+  size_t filled = 0;
+  size_t spikes = 0; // total since start
+
+  void add(float ms) {
+    samples[next] = ms;
+    next = (next + 1) % WINDOW;
+    if (filled < WINDOW)
+      ++filled;
+    if (ms > SPIKE_MS)
+      ++spikes;
+  }
+
+  float avg() const {
+    float sum = 0.0f;
+    for (size_t i = 0; i < filled; ++i) {
+      sum += samples[i];
+    }
+    return filled ? sum / static_cast<float>(filled) : 0.0f;
+  }
+
+  float max() const {
+    return filled ? *std::max_element(samples.begin(),
+                                      samples.begin() + filled)
+                  : 0.0f;
+  }
+};
@@ -4,18 +4,28 @@
 #include "CheatState.h"
 #include "Coord.h"
 #include "FastRand.h"
+#include "FlowField.h"
+#include "FrameStats.h"
 #include "Mob.h"
+#include "MobPaths.h"
 #include "MobStorage.h"
 #include "Pathfinding.h"
 #include "Pixel.h"
 #include "Terrain.h"
 #include "Window.h"
 #include "World.h"
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <optional>
 #include <string>
+#include <vector>
 
 class GameWindow : public Window {
 private:
   MobStorage mobs;
+  MobPaths mob_paths; // each mob's plan, index for index with mobs
   World &world;
   int &player_x;
   int &player_y;
@@ -36,13 +46,57 @@ private:
   float mob_accum = 0.0f;
   float dmg_accum = 0.0f;
   float fps = 0.0f;
+  FrameStats frame_stats;
+  int prev_player_x = 0;
+  float speed_ema = 0.0f; // blocks per ms, smoothed
   BloomFilter spawn_bloom{16384, 3};
   int spawn_bloom_count = 0;
+  FlowField flow_field; // toward the player, built when many mobs replan
+  std::vector<size_t> replanning; // mobs that need a new plan this tick
+  float path_rate_accum = 0.0f;
+  // Searches MobPaths skipped: per-mob bfs_findpath calls on ticks below
+  // FIELD_MIN_MOBS, field builds on ticks at or above it
+  size_t searches_avoided = 0;
+  size_t searches_avoided_mark = 0;
+  float searches_avoided_per_sec = 0.0f;
 
   static constexpr float GRAVITY_MS = 250.0f;
   static constexpr float SPAWN_MS = 6000.0f;
   static constexpr float MOB_MOVE_MS = 500.0f;
   static constexpr float DMG_COOLDOWN_MS = 2000.0f;
+  static constexpr int MOB_ACTIVE_RADIUS = 60;
+  // A mob keeps its path until the player is this far from where it led
+  static constexpr int PATH_REPLAN_DIST = 3;
+  // Below this many replans in one tick, each mob runs its own
+  // bfs_findpath: most fail at may_reach for next to nothing, while a
+  // field build costs 30-500 us however few mobs use it
+  static constexpr size_t FIELD_MIN_MOBS = 32;
+  // Camera and active mobs stay resident, plus a chunk of slack
+  static constexpr int PIN_RADIUS = MOB_ACTIVE_RADIUS + CHUNK_SIZE;
+  // How far ahead (in ms of travel at current speed) to generate terrain
+  static constexpr float PREFETCH_MS = 500.0f;
+  // Reads for mobs and spawning load chunks only within the frame budget
+  static constexpr World::Generate BUDGETED = World::Generate::WITHIN_BUDGET;
+
+  // Queue generation for the camera area plus a look-ahead strip in the
+  // facing direction that grows with speed, so a speed_boost sprint finds
+  // its terrain already generated.
+  void prefetch_ahead() {
+    if (!world.async_generation())
+      return;
+    if (dt > 0.0f) {
+      float speed = static_cast<float>(std::abs(player_x - prev_player_x)) / dt;
+      speed_ema = 0.8f * speed_ema + 0.2f * speed;
+    }
+    prev_player_x = player_x;
+
+    int cam_x = player_x - SCREEN_WIDTH / 2;
+    int cam_y = player_y - SCREEN_HEIGHT / 2;
+    int ahead = CHUNK_SIZE + static_cast<int>(speed_ema * PREFETCH_MS);
+    int x0 = (facing < 0) ? cam_x - ahead : cam_x;
+    world.prefetch_region(x0, std::max(cam_y, 0), SCREEN_WIDTH + ahead,
+                          std::min(SCREEN_HEIGHT, CHUNK_SIZE));
+  }
 
 public:
   bool wants_inventory = false;
@@ -50,6 +104,8 @@ public:
   bool wants_pause = false;
 
   MobStorage &get_mobs() { return mobs; }
+  const FrameStats &get_frame_stats() const { return frame_stats; }
+  void record_frame_ms(float ms) { frame_stats.add(ms); }
   int get_hp() const { return hp; }
   void set_hp(int h) { hp = h; }
   void set_dt(float d) {
@@ -78,6 +134,11 @@ public:
       return false;
     }
 
+    world.set_pin_area(player_x, player_y, PIN_RADIUS);
+    world.begin_frame();
+    world.pump_generated();
+    prefetch_ahead();
+
     int nw_x = player_x;
     if (input.move_left) {
       nw_x--;
@@ -92,10 +153,8 @@ public:
       if (cheats.spectator_mode) {
         --player_y;
       } else {
-        bool on_ground =
-            world.get_block(player_x, player_y + 1) != BlockType::AIR;
-        bool above_clear =
-            world.get_block(player_x, player_y - 1) == BlockType::AIR;
+        bool on_ground = !world.is_air(player_x, player_y + 1);
+        bool above_clear = world.is_air(player_x, player_y - 1);
         if (on_ground && above_clear) {
           player_y--;
           fall_accum = 0.0f;
@@ -136,8 +195,7 @@ public:
 
     if (input.place_block) {
       int place_x, place_y;
-      bool on_ground =
-          world.get_block(player_x, player_y + 1) != BlockType::AIR;
+      bool on_ground = !world.is_air(player_x, player_y + 1);
       if (on_ground) {
         place_x = player_x + facing;
         place_y = player_y;
@@ -145,7 +203,7 @@ public:
         place_x = player_x;
         place_y = player_y + 1;
       }
-      if (world.get_block(place_x, place_y) == BlockType::AIR) {
+      if (world.is_air(place_x, place_y)) {
         BlockType block_toplace = static_cast<BlockType>(selected_block);
         if (inventory[selected_block] > 0) {
           world.set_block(place_x, place_y, block_toplace);
@@ -158,8 +216,7 @@ public:
       selected_block = input.select_block;
     }
 
-    if (cheats.spectator_mode or
-        world.get_block(nw_x, player_y) == BlockType::AIR) {
+    if (cheats.spectator_mode or world.is_air(nw_x, player_y)) {
       player_x = nw_x;
     }
 
@@ -169,8 +226,7 @@ public:
         nw_x2--;
       if (input.move_right)
         nw_x2++;
-      if (cheats.spectator_mode or
-          world.get_block(nw_x2, player_y) == BlockType::AIR) {
+      if (cheats.spectator_mode or world.is_air(nw_x2, player_y)) {
         player_x = nw_x2;
       }
     }
@@ -179,7 +235,7 @@ public:
       fall_accum += dt;
       while (fall_accum >= GRAVITY_MS) {
         fall_accum -= GRAVITY_MS;
-        if (world.get_block(player_x, player_y + 1) == BlockType::AIR) {
+        if (world.is_air(player_x, player_y + 1)) {
           player_y++;
           fall_distance++;
         } else {
@@ -213,17 +269,19 @@ public:
       int sx = player_x + offset;
       int sy = player_y;
 
-      while (sy < CHUNK_SIZE - 1 and
-             world.get_block(sx, sy) == BlockType::AIR) {
-        ++sy;
-      }
-      --sy;
+      // Drop to the first solid cell (or the bottom row). Spawning never
+      // forces generation beyond the frame budget.
+      std::optional<int> ground = world.try_first_solid_below(
+          sx, sy, std::max(sy - 1, CHUNK_SIZE - 2), BUDGETED);
+      if (ground)
+        sy = *ground - 1;
 
-      if (sy > 0) {
+      if (ground && sy > 0) {
         if (!spawn_bloom.maybe_contains(sx, sy)) {
           spawn_bloom.insert(sx, sy);
           ++spawn_bloom_count;
           mobs.add(sx, sy, 20, MobType::ZOMBIE, AIState::CHASING);
+          mob_paths.add();
         }
         if (spawn_bloom_count > 500) {
           spawn_bloom.clear();
@@ -232,32 +290,88 @@ public:
       }
     }
 
+    // Searches the path cache saved, per second over the last second
+    path_rate_accum += dt;
+    if (path_rate_accum >= 1000.0f) {
+      searches_avoided_per_sec =
+          static_cast<float>(searches_avoided - searches_avoided_mark) *
+          1000.0f / path_rate_accum;
+      searches_avoided_mark = searches_avoided;
+      path_rate_accum = 0.0f;
+    }
+
     mob_accum += dt;
     if (mob_accum >= MOB_MOVE_MS) {
       mob_accum -= MOB_MOVE_MS;
 
       Coord player_pos = {player_x, player_y};
-
+      mob_paths.resize(mobs.count()); // mobs from a loaded save
+      replanning.clear();
+      // Without MobPaths every grounded mob would plan: below
+      // FIELD_MIN_MOBS each with its own search, so every reused plan
+      // skips one; otherwise with one field, skipped if none is built
+      // though some mob has a way to the player (as a kept, non-empty
+      // plan shows)
+      size_t planning = 0, reused = 0;
+      bool would_build = false;
+
+      // Mobs only chase the player, never each other, so every plan can
+      // be made before anyone moves
       for (size_t i = 0; i < mobs.count(); ++i) {
         Coord mob_pos = mobs.get_pos(i);
 
         int dx = mob_pos.x - player_x;
         int dy = mob_pos.y - player_y;
 
-        if ((dx * dx + dy * dy) > 3600) {
+        if ((dx * dx + dy * dy) > MOB_ACTIVE_RADIUS * MOB_ACTIVE_RADIUS) {
           continue;
         }
 
-        if (world.get_block(mob_pos.x, mob_pos.y + 1) == BlockType::AIR) {
+        if (world.try_is_air(mob_pos.x, mob_pos.y + 1, BUDGETED) == true) {
           mobs.set_pos(i, {mob_pos.x, mob_pos.y + 1});
+          continue;
+        }
+        ++planning;
+        if (mob_paths.reuse(i, mob_pos, player_pos, world,
+                            PATH_REPLAN_DIST)) {
+          ++reused;
+          would_build |= !mob_paths.moves[i].empty();
+          if (std::optional<Coord> next = mob_paths.advance(i))
+            mobs.set_pos(i, *next);
         } else {
-          std::vector<Coord> path =
-              bfs_findpath(mob_pos, player_pos, world, 150);
-          if (path.size() >= 2) {
-            mobs.set_pos(i, path[1]);
+          replanning.push_back(i);
+        }
+      }
+
+      // Enough replans share one search from the player; a few search
+      // on their own
+      bool use_field = replanning.size() >= FIELD_MIN_MOBS;
+      bool field_built = false;
+      for (size_t i : replanning) {
+        Coord mob_pos = mobs.get_pos(i);
+        if (!use_field) {
+          mob_paths.plan_path(i, mob_pos, player_pos, world.edit_epoch(),
+                              bfs_findpath(mob_pos, player_pos, world,
+                                           FlowField::DEFAULT_MAX_DEPTH));
+        } else if (world.may_reach(mob_pos, player_pos)) {
+          // A player sealed off from every mob needs no field at all
+          if (!field_built) {
+            build_flow_field(flow_field, player_pos, world);
+            field_built = true;
           }
+          mob_paths.plan(i, mob_pos, player_pos, world.edit_epoch(),
+                         [&](Coord c) { return flow_field.next_move(c); });
+        } else {
+          mob_paths.plan(i, mob_pos, player_pos, world.edit_epoch(),
+                         [](Coord) { return std::optional<uint8_t>(); });
         }
+        if (std::optional<Coord> next = mob_paths.advance(i))
+          mobs.set_pos(i, *next);
       }
+      if (planning < FIELD_MIN_MOBS)
+        searches_avoided += reused;
+      else if (would_build && !field_built)
+        ++searches_avoided;
     }
 
     if (dmg_accum > 0.0f) {
@@ -279,8 +393,7 @@ public:
           int knockback_x = (dx <= 0) ? 1 : -1;
           for (int k = 0; k < 2; k++) {
             int nx = player_x + knockback_x;
-            if (cheats.spectator_mode ||
-                world.get_block(nx, player_y) == BlockType::AIR) {
+            if (cheats.spectator_mode || world.is_air(nx, player_y)) {
               player_x = nx;
             }
           }
@@ -321,27 +434,30 @@ public:
     int cam_x = player_x - SCREEN_WIDTH / 2;
     int cam_y = player_y - SCREEN_HEIGHT / 2;
 
+    // Viewport plus a one-cell border, so the ore exposure test reads its
+    // neighbours from the same grid. Sky above and bedrock below the terrain
+    // row come from the world's shared uniform chunks.
+    constexpr int VIEW_W = SCREEN_WIDTH + 2;
+    constexpr int VIEW_H = SCREEN_HEIGHT + 2;
+    std::array<BlockType, VIEW_W * VIEW_H> view;
+    world.copy_region(cam_x - 1, cam_y - 1, VIEW_W, VIEW_H, view.data(), false);
+
     for (int sy = 0; sy < SCREEN_HEIGHT; ++sy) {
+      const BlockType *row = view.data() + (sy + 1) * VIEW_W + 1;
       for (int sx = 0; sx < SCREEN_WIDTH; ++sx) {
-        int wx = cam_x + sx;
-        int wy = cam_y + sy;
-
-        BlockType block;
-        if (wy < 0) {
-          block = BlockType::AIR;
-        } else if (wy >= CHUNK_SIZE) {
-          block = BlockType::BEDROCK;
-        } else {
-          block = world.get_block(wx, wy);
+        BlockType block = row[sx];
+        if (block == World::PENDING) {
+          screen.set_pixel(sx, sy, {'~', Color::GRAY});
+          continue;
         }
         bool is_ore = (block == BlockType::DIAMOND or
                        block == BlockType::GOLD or block == BlockType::IRON);
 
         if (is_ore) {
-          bool exposed = world.get_block(wx, wy + 1) == BlockType::AIR or
-                         world.get_block(wx + 1, wy) == BlockType::AIR or
-                         world.get_block(wx - 1, wy) == BlockType::AIR or
-                         world.get_block(wx, wy - 1) == BlockType::AIR;
+          bool exposed = row[sx + VIEW_W] == BlockType::AIR or
+                         row[sx + 1] == BlockType::AIR or
+                         row[sx - 1] == BlockType::AIR or
+                         row[sx - VIEW_W] == BlockType::AIR;
 
           if (exposed) {
             screen.set_pixel(sx, sy, block_to_pixel(block));
@@ -400,6 +516,34 @@ public:
                      : (hp > 20) ? Color::YELLOW
                                  : Color::BRIGHT_RED;
     screen.draw_text(0, 2, hp_bar, hp_color);
+
+    char frame_hud[64];
+    std::snprintf(frame_hud, sizeof(frame_hud),
+                  "Frame: %.1fms avg %.1fms max %zu spikes",
+                  frame_stats.avg(), frame_stats.max(), frame_stats.spikes);
+    screen.draw_text(45, 2, frame_hud, Color::GRAY);
+
+    char path_hud[64];
+    std::snprintf(path_hud, sizeof(path_hud),
+                  "Paths: %.0f%% cached, %.1f searches avoided/s",
+                  mob_paths.hit_rate() * 100.0, searches_avoided_per_sec);
+    screen.draw_text(45, 3, path_hud, Color::GRAY);
+
+    // Chunk index telemetry, only in -DROBINHOOD_STATS builds
+    if constexpr (RobinHoodStats::enabled) {
+      const auto &chunk_map = world.chunk_map();
+      RobinHoodStats st = chunk_map.stats();
+      char map_hud[96];
+      std::snprintf(map_hud, sizeof(map_hud),
+                    "Chunks: %zu/%zu probe %.2f max %llu grows %llu "
+                    "shift %.2f max %llu",
+                    chunk_map.size(), chunk_map.capacity(), st.avg_probe(),
+                    static_cast<unsigned long long>(st.max_probe),
+                    static_cast<unsigned long long>(st.grows),
+                    st.avg_erase_shift(),
+                    static_cast<unsigned long long>(st.max_erase_shift));
+      screen.draw_text(0, 4, map_hud, Color::GRAY);
+    }
   }
 
   bool is_opaque() const override { return true; }
@@ -1,8 +1,17 @@
 #pragma once
+#include "ConcurrentRobinHoodMap.h"
 #include "Coord.h"
 #include "RobinHoodMap.h"
+#include "RobinHoodSet.h"
+#include "Terrain.h"
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cstdint>
+#include <iomanip>
 #include <iostream>
+#include <random>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -12,6 +21,8 @@
 //
 //  Tests: Sequential Insert, Random Lookup (Hit), Random Lookup (Miss),
 //         Full Iteration. All using Coord keys (real game data type).
+//         Lookups visit keys in a shuffled order — walking them in insertion
+//         order lets unordered_map stream its nodes in allocation order.
 //
 // ============================================================================
 
@@ -38,6 +49,14 @@ inline void run_hash_benchmark() {
     miss_keys[i] = {i * 7 + 13 + 1000000, i * 3 - 500 + 1000000};
   }
 
+  // Shuffled lookup order (fixed seed, same for both maps)
+  std::mt19937 rng(12345);
+  std::vector<Coord> hit_keys(NUM_LOOKUPS);
+  for (int i = 0; i < NUM_LOOKUPS; ++i) {
+    hit_keys[i] = keys[rng() % NUM_ENTRIES];
+  }
+  std::shuffle(miss_keys.begin(), miss_keys.end(), rng);
+
   volatile int sink = 0;
 
   // ---- BENCHMARK 1: SEQUENTIAL INSERT ----
@@ -83,30 +102,44 @@ inline void run_hash_benchmark() {
     rmap_filled[keys[i]] = i;
   }
 
+  // Lookup passes take a few ms; report the best of several so one
+  // scheduler hiccup doesn't decide the comparison
+  const int REPEATS = 5;
+  auto best_us = [&](auto &&pass) {
+    long long best = -1;
+    for (int r = 0; r < REPEATS; ++r) {
+      auto p1 = std::chrono::high_resolution_clock::now();
+      pass();
+      auto p2 = std::chrono::high_resolution_clock::now();
+      long long us =
+          std::chrono::duration_cast<std::chrono::microseconds>(p2 - p1)
+              .count();
+      if (best < 0 || us < best)
+        best = us;
+    }
+    return best;
+  };
+
   // ---- BENCHMARK 2: RANDOM LOOKUP (HIT) ----
   std::cout << "--- Random Lookup (Hit) ---\n";
 
-  t1 = std::chrono::high_resolution_clock::now();
-  for (int i = 0; i < NUM_LOOKUPS; ++i) {
-    auto it = umap_filled.find(keys[i % NUM_ENTRIES]);
-    if (it != umap_filled.end())
-      sink = it->second;
-  }
-  t2 = std::chrono::high_resolution_clock::now();
-  auto umap_hit =
-      std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count();
+  auto umap_hit = best_us([&] {
+    for (int i = 0; i < NUM_LOOKUPS; ++i) {
+      auto it = umap_filled.find(hit_keys[i]);
+      if (it != umap_filled.end())
+        sink = it->second;
+    }
+  });
 
-  t1 = std::chrono::high_resolution_clock::now();
-  for (int i = 0; i < NUM_LOOKUPS; ++i) {
-    auto it = rmap_filled.find(keys[i % NUM_ENTRIES]);
-    if (it != rmap_filled.end()) {
-      auto [k, v] = *it;
-      sink = v;
+  auto rmap_hit = best_us([&] {
+    for (int i = 0; i < NUM_LOOKUPS; ++i) {
+      auto it = rmap_filled.find(hit_keys[i]);
+      if (it != rmap_filled.end()) {
+        auto [k, v] = *it;
+        sink = v;
+      }
     }
-  }
-  t2 = std::chrono::high_resolution_clock::now();
-  auto rmap_hit =
-      std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count();
+  });
 
   double hit_speedup =
       static_cast<double>(umap_hit) / static_cast<double>(rmap_hit);
@@ -117,27 +150,23 @@ inline void run_hash_benchmark() {
   // ---- BENCHMARK 3: RANDOM LOOKUP (MISS) ----
   std::cout << "--- Random Lookup (Miss) ---\n";
 
-  t1 = std::chrono::high_resolution_clock::now();
-  for (int i = 0; i < NUM_LOOKUPS; ++i) {
-    auto it = umap_filled.find(miss_keys[i]);
-    if (it != umap_filled.end())
-      sink = it->second;
-  }
-  t2 = std::chrono::high_resolution_clock::now();
-  auto umap_miss =
-      std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count();
+  auto umap_miss = best_us([&] {
+    for (int i = 0; i < NUM_LOOKUPS; ++i) {
+      auto it = umap_filled.find(miss_keys[i]);
+      if (it != umap_filled.end())
+        sink = it->second;
+    }
+  });
 
-  t1 = std::chrono::high_resolution_clock::now();
-  for (int i = 0; i < NUM_LOOKUPS; ++i) {
-    auto it = rmap_filled.find(miss_keys[i]);
-    if (it != rmap_filled.end()) {
-      auto [k, v] = *it;
-      sink = v;
+  auto rmap_miss = best_us([&] {
+    for (int i = 0; i < NUM_LOOKUPS; ++i) {
+      auto it = rmap_filled.find(miss_keys[i]);
+      if (it != rmap_filled.end()) {
+        auto [k, v] = *it;
+        sink = v;
+      }
     }
-  }
-  t2 = std::chrono::high_resolution_clock::now();
-  auto rmap_miss =
-      std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count();
+  });
 
   double miss_speedup =
       static_cast<double>(umap_miss) / static_cast<double>(rmap_miss);
@@ -181,3 +210,586 @@ inline void run_hash_benchmark() {
 
   (void)sink;
 }
+
+// ============================================================================
+//  Hash Distribution Report: probe sequence lengths for real key patterns
+// ============================================================================
+//
+//  Fills a RobinHoodMap with the coords the game actually produces and
+//  prints its PSL histogram (entries 0, 1, 2, ... slots from home), once
+//  with the old xor-multiply CoordHash and once with the current one.
+//
+//  1. chunks — a 256 x 8 block of chunk coords (a long walk)
+//  2. bfs    — every world coord in a 301 x 61 window (one BFS's reach)
+//  3. stride — world coords on a CHUNK_SIZE grid (chunk origins)
+//
+// ============================================================================
+
+// The CoordHash this repo shipped before fmix64: std::hash<int> is the
+// identity on libstdc++, so x lands in the low bits almost unmixed.
+// Flagged as mixed so the map uses it raw, as it did back then.
+struct XorMulCoordHash {
+  using is_avalanching = void;
+
+  size_t operator()(const Coord &c) const {
+    size_t h1 = static_cast<size_t>(static_cast<unsigned>(c.x));
+    size_t h2 = static_cast<size_t>(static_cast<unsigned>(c.y));
+    return h1 ^ (h2 * 2654435761u);
+  }
+};
+
+// "mean PSL m, max d, load f" and the histogram on the next line: 0..7
+// individually, then everything further out in one bucket
+template <typename Map>
+inline void print_psl(const char *label, const Map &map) {
+  std::vector<size_t> hist = map.psl_histogram();
+
+  double total = 0.0;
+  for (size_t d = 0; d < hist.size(); ++d) {
+    total += static_cast<double>(d) * static_cast<double>(hist[d]);
+  }
+  std::cout << "  " << label << ": mean PSL "
+            << (map.size() ? total / static_cast<double>(map.size()) : 0.0)
+            << ", max " << (hist.empty() ? 0 : hist.size() - 1) << ", load "
+            << map.load_factor() << "\n    ";
+
+  size_t tail = 0;
+  for (size_t d = 0; d < hist.size(); ++d) {
+    if (d < 8)
+      std::cout << d << ":" << hist[d] << " ";
+    else
+      tail += hist[d];
+  }
+  if (tail)
+    std::cout << "8+:" << tail;
+  std::cout << "\n";
+}
+
+template <typename Hash>
+inline void report_psl(const char *label, const std::vector<Coord> &keys) {
+  RobinHoodMap<Coord, int, Hash> map;
+  for (size_t i = 0; i < keys.size(); ++i) {
+    map[keys[i]] = static_cast<int>(i);
+  }
+  print_psl(label, map);
+}
+
+// Everything a map knows about itself: the PSL snapshot, and with
+// ROBINHOOD_STATS the counters behind it
+template <typename Map>
+inline void print_map_stats(const char *label, const Map &map) {
+  std::cout << "--- " << label << " (" << map.size() << " entries, capacity "
+            << map.capacity() << ") ---\n";
+  print_psl("now", map);
+
+  RobinHoodStats st = map.stats();
+  if (!RobinHoodStats::enabled) {
+    std::cout << "  (probe/grow/erase counters: build with "
+                 "-DROBINHOOD_STATS)\n";
+    return;
+  }
+  std::cout << "  Probes:  " << st.probes << ", avg " << st.avg_probe()
+            << " slots, max " << st.max_probe << ", key compares "
+            << st.key_compares << "\n";
+  std::cout << "  Grows:   " << st.grows << "\n";
+  std::cout << "  Erases:  " << st.erases << ", avg shift "
+            << st.avg_erase_shift() << ", max " << st.max_erase_shift << "\n";
+}
+
+inline void run_hash_distribution_report() {
+  std::cout << "\n========================================\n";
+  std::cout << "   HASH DISTRIBUTION REPORT\n";
+  std::cout << "   PSL histogram, xor-multiply vs fmix64\n";
+  std::cout << "========================================\n\n";
+
+  std::vector<Coord> chunks;
+  for (int cy = -4; cy < 4; ++cy) {
+    for (int cx = -128; cx < 128; ++cx) {
+      chunks.push_back({cx, cy});
+    }
+  }
+
+  std::vector<Coord> bfs;
+  for (int y = -30; y <= 30; ++y) {
+    for (int x = -150; x <= 150; ++x) {
+      bfs.push_back({1000 + x, 10 + y});
+    }
+  }
+
+  std::vector<Coord> stride;
+  for (int y = 0; y < 16; ++y) {
+    for (int x = 0; x < 512; ++x) {
+      stride.push_back({x * CHUNK_SIZE, y * CHUNK_SIZE});
+    }
+  }
+
+  struct Pattern {
+    const char *name;
+    const std::vector<Coord> &keys;
+  };
+  for (const Pattern &p : {Pattern{"chunks", chunks}, Pattern{"bfs", bfs},
+                           Pattern{"stride", stride}}) {
+    std::cout << "--- " << p.name << " (" << p.keys.size() << " keys) ---\n";
+    report_psl<XorMulCoordHash>("xor-multiply", p.keys);
+    report_psl<CoordHash>("fmix64      ", p.keys);
+    std::cout << "\n";
+  }
+}
+
+// ============================================================================
+//  Slot Layout Benchmark: RobinHoodAoS vs RobinHoodSoA
+// ============================================================================
+//
+//  Same keys, same capacity (fixed, so load is set by the key count), two
+//  value sizes. Per layout and load factor:
+//
+//  hit  — find a present key and read its value (shuffled order)
+//  miss — find an absent key
+//  iter — walk the map summing one word of every value
+//
+//  AoS puts a hit's value on the line the key was compared on; SoA keeps
+//  probes on the (denser) key array and iteration on the value array.
+//
+// ============================================================================
+
+struct FatValue {
+  int first = 0;
+  int rest[7] = {};
+};
+
+inline int &value_word(int &v) { return v; }
+inline int &value_word(FatValue &v) { return v.first; }
+
+struct LayoutTimes {
+  double hit_ns, miss_ns, iter_ns; // per lookup / per entry
+};
+
+template <typename V, typename Layout>
+inline LayoutTimes time_layout(const std::vector<Coord> &keys,
+                               const std::vector<Coord> &hits,
+                               const std::vector<Coord> &misses, size_t cap) {
+  RobinHoodMap<Coord, V, CoordHash, std::equal_to<Coord>, Layout> map(cap);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    value_word(map[keys[i]]) = static_cast<int>(i);
+  }
+
+  volatile int sink = 0;
+  auto best_ns = [&](auto &&pass, size_t ops) {
+    long long best = -1;
+    for (int r = 0; r < 5; ++r) {
+      auto t1 = std::chrono::high_resolution_clock::now();
+      pass();
+      auto t2 = std::chrono::high_resolution_clock::now();
+      long long ns =
+          std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1)
+              .count();
+      if (best < 0 || ns < best)
+        best = ns;
+    }
+    return static_cast<double>(best) / static_cast<double>(ops);
+  };
+
+  LayoutTimes t;
+  t.hit_ns = best_ns(
+      [&] {
+        for (const Coord &c : hits) {
+          auto it = map.find(c);
+          if (it != map.end())
+            sink = value_word((*it).second);
+        }
+      },
+      hits.size());
+  t.miss_ns = best_ns(
+      [&] {
+        for (const Coord &c : misses) {
+          if (map.find(c) != map.end())
+            sink = 1;
+        }
+      },
+      misses.size());
+  t.iter_ns = best_ns(
+      [&] {
+        unsigned sum = 0;
+        for (auto [k, v] : map) {
+          sum += static_cast<unsigned>(value_word(v));
+        }
+        sink = static_cast<int>(sum);
+      },
+      map.size());
+  (void)sink;
+  return t;
+}
+
+template <typename V>
+inline void report_layouts(const char *label, size_t cap,
+                           const std::vector<Coord> &keys,
+                           const std::vector<Coord> &misses) {
+  std::cout << "--- value = " << label << " (" << sizeof(V)
+            << " B), capacity " << cap << " ---\n";
+  std::cout << "  load  layout  hit ns  miss ns  iter ns/entry\n";
+
+  std::mt19937 rng(12345);
+  for (double load : {0.25, 0.50, 0.70}) {
+    size_t n = static_cast<size_t>(load * static_cast<double>(cap));
+    std::vector<Coord> used(keys.begin(), keys.begin() + n);
+    std::vector<Coord> hits(misses.size());
+    for (Coord &c : hits) {
+      c = used[rng() % n];
+    }
+
+    LayoutTimes aos = time_layout<V, RobinHoodAoS>(used, hits, misses, cap);
+    LayoutTimes soa = time_layout<V, RobinHoodSoA>(used, hits, misses, cap);
+    for (auto [name, t] : {std::pair{"AoS", aos}, std::pair{"SoA", soa}}) {
+      std::cout << std::fixed << std::setprecision(2) << "  " << load << "  "
+                << name << std::setprecision(1) << std::setw(11) << t.hit_ns
+                << std::setw(9) << t.miss_ns << std::setw(11) << t.iter_ns
+                << "\n";
+    }
+  }
+  std::cout << "\n";
+}
+
+inline void run_hash_layout_benchmark() {
+  const size_t CAPACITY = size_t{1} << 18;
+  const int NUM_LOOKUPS = 200000;
+
+  std::cout << "\n========================================\n";
+  std::cout << "   SLOT LAYOUT BENCHMARK\n";
+  std::cout << "   RobinHoodAoS vs RobinHoodSoA\n";
+  std::cout << "========================================\n\n";
+
+  std::vector<Coord> keys(CAPACITY);
+  for (size_t i = 0; i < CAPACITY; ++i) {
+    int n = static_cast<int>(i);
+    keys[i] = {n * 7 + 13, n * 3 - 500};
+  }
+  std::vector<Coord> misses(NUM_LOOKUPS);
+  for (int i = 0; i < NUM_LOOKUPS; ++i) {
+    misses[i] = {i * 7 + 13 + 5000000, i * 3 - 500 + 5000000};
+  }
+
+  report_layouts<int>("int", CAPACITY, keys, misses);
+  report_layouts<FatValue>("FatValue", CAPACITY, keys, misses);
+  std::cout << std::defaultfloat << std::setprecision(6);
+}
+
+// ============================================================================
+//  Rehash Latency Benchmark: stop-the-world grow vs incremental migration
+// ============================================================================
+//
+//  Times every single insert of a growing map. Throughput hides grow
+//  stalls: one insert in a few hundred thousand pays for rehashing the
+//  whole table, and that one lands inside some frame. Reports total time
+//  alongside the worst and 99.99th-percentile single insert.
+//
+// ============================================================================
+
+struct InsertLatency {
+  long long total_us;
+  long long worst_ns;
+  long long p9999_ns;
+};
+
+inline InsertLatency time_inserts(const std::vector<Coord> &keys,
+                                  bool incremental) {
+  RobinHoodMap<Coord, int, CoordHash> map;
+  map.set_incremental_rehash(incremental);
+
+  std::vector<long long> ns(keys.size());
+  auto start = std::chrono::high_resolution_clock::now();
+  for (size_t i = 0; i < keys.size(); ++i) {
+    auto t1 = std::chrono::high_resolution_clock::now();
+    map[keys[i]] = static_cast<int>(i);
+    auto t2 = std::chrono::high_resolution_clock::now();
+    ns[i] =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count();
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+
+  InsertLatency r;
+  r.total_us =
+      std::chrono::duration_cast<std::chrono::microseconds>(end - start)
+          .count();
+  std::sort(ns.begin(), ns.end());
+  r.worst_ns = ns.back();
+  r.p9999_ns = ns[ns.size() - 1 - ns.size() / 10000];
+  return r;
+}
+
+inline void run_rehash_latency_benchmark() {
+  const int NUM_ENTRIES = 1000000;
+
+  std::cout << "\n========================================\n";
+  std::cout << "   REHASH LATENCY BENCHMARK\n";
+  std::cout << "   per-insert time, " << NUM_ENTRIES << " inserts\n";
+  std::cout << "========================================\n\n";
+
+  std::vector<Coord> keys(NUM_ENTRIES);
+  for (int i = 0; i < NUM_ENTRIES; ++i) {
+    keys[i] = {i * 7 + 13, i * 3 - 500};
+  }
+
+  InsertLatency stw = time_inserts(keys, false);
+  InsertLatency inc = time_inserts(keys, true);
+
+  for (auto [name, r] : {std::pair{"stop-the-world", stw},
+                         std::pair{"incremental   ", inc}}) {
+    std::cout << "  " << name << ": total " << r.total_us / 1000
+              << " ms, worst insert " << r.worst_ns / 1000
+              << " us, p99.99 " << r.p9999_ns << " ns\n";
+  }
+  std::cout << "  Worst-insert improvement: "
+            << static_cast<double>(stw.worst_ns) /
+                   static_cast<double>(inc.worst_ns)
+            << "x\n";
+}
+
+// ============================================================================
+//  Batched Lookup Benchmark: find() loop vs find_many()
+// ============================================================================
+//
+//  The same shuffled hit keys resolved one find() at a time and through
+//  find_many(), which hashes a block of keys and prefetches their home
+//  groups before resolving any. At 100K entries the control bytes sit in
+//  L2 and only slot lines miss; at 10M nearly every probe goes to DRAM,
+//  which is where overlapping the misses pays.
+//
+// ============================================================================
+
+inline void report_batched_lookup(int num_entries, int num_lookups) {
+  std::vector<Coord> keys(num_entries);
+  for (int i = 0; i < num_entries; ++i) {
+    keys[i] = {i * 7 + 13, i * 3 - 500};
+  }
+  RobinHoodMap<Coord, int, CoordHash> map;
+  map.reserve(keys.size());
+  for (int i = 0; i < num_entries; ++i) {
+    map.try_emplace(keys[i], i);
+  }
+
+  std::mt19937 rng(12345);
+  std::vector<Coord> hits(num_lookups);
+  for (Coord &c : hits) {
+    c = keys[rng() % keys.size()];
+  }
+  std::vector<int *> out(hits.size());
+
+  volatile long long sink = 0;
+  auto best_us = [&](auto &&pass) {
+    long long best = -1;
+    for (int r = 0; r < 3; ++r) {
+      auto t1 = std::chrono::high_resolution_clock::now();
+      pass();
+      auto t2 = std::chrono::high_resolution_clock::now();
+      long long us =
+          std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1)
+              .count();
+      if (best < 0 || us < best)
+        best = us;
+    }
+    return best;
+  };
+
+  long long single = best_us([&] {
+    long long sum = 0;
+    for (const Coord &c : hits) {
+      auto it = map.find(c);
+      if (it != map.end())
+        sum += (*it).second;
+    }
+    sink = sum;
+  });
+  long long batched = best_us([&] {
+    map.find_many(hits, out);
+    long long sum = 0;
+    for (int *v : out) {
+      if (v)
+        sum += *v;
+    }
+    sink = sum;
+  });
+  (void)sink;
+
+  double per = 1000.0 / static_cast<double>(num_lookups);
+  std::cout << "--- " << num_entries << " entries, " << num_lookups
+            << " hit lookups ---\n";
+  std::cout << "  find() loop: " << single << " us ("
+            << static_cast<double>(single) * per << " ns/lookup)\n";
+  std::cout << "  find_many(): " << batched << " us ("
+            << static_cast<double>(batched) * per << " ns/lookup)\n";
+  std::cout << "  Speedup:     "
+            << static_cast<double>(single) / static_cast<double>(batched)
+            << "x\n\n";
+}
+
+inline void run_batched_lookup_benchmark() {
+  std::cout << "\n========================================\n";
+  std::cout << "   BATCHED LOOKUP BENCHMARK\n";
+  std::cout << "   RobinHoodMap find() vs find_many()\n";
+  std::cout << "========================================\n\n";
+
+  report_batched_lookup(100000, 1000000);
+  report_batched_lookup(10000000, 1000000);
+}
+
+// ============================================================================
+//  Concurrent Map Benchmark: 16 shards vs 1 shard (a single global lock)
+// ============================================================================
+//
+//  Each of T threads runs the same number of ops over a shared pre-filled
+//  map of Coord keys: visit() for reads, insert_or_assign() on an existing
+//  key for writes. T goes 1, 2, 4, ... up to hardware_concurrency, at three
+//  read/write mixes. Reported as total Mops/s across all threads — flat
+//  means no scaling, the single-shard column shows what a global lock
+//  costs once writers appear.
+//
+// ============================================================================
+
+template <size_t SHARDS>
+inline double concurrent_mops(const std::vector<Coord> &keys, unsigned threads,
+                              int ops_per_thread, int write_pct) {
+  ConcurrentRobinHoodMap<Coord, int, CoordHash, std::equal_to<Coord>, SHARDS>
+      map;
+  for (size_t i = 0; i < keys.size(); ++i)
+    map.try_emplace(keys[i], static_cast<int>(i));
+
+  std::atomic<long long> sink{0};
+  auto worker = [&](unsigned id) {
+    std::mt19937 rng(1000 + id);
+    long long sum = 0;
+    for (int i = 0; i < ops_per_thread; ++i) {
+      const Coord &c = keys[rng() % keys.size()];
+      if (static_cast<int>(rng() % 100) < write_pct)
+        map.insert_or_assign(c, i);
+      else
+        map.visit(c, [&](int v) { sum += v; });
+    }
+    sink += sum;
+  };
+
+  auto t1 = std::chrono::high_resolution_clock::now();
+  std::vector<std::thread> pool;
+  for (unsigned t = 0; t < threads; ++t)
+    pool.emplace_back(worker, t);
+  for (std::thread &th : pool)
+    th.join();
+  auto t2 = std::chrono::high_resolution_clock::now();
+
+  double us = static_cast<double>(
+      std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count());
+  double total = static_cast<double>(ops_per_thread) * threads;
+  return us > 0 ? total / us : 0.0;
+}
+
+inline void run_concurrent_map_benchmark() {
+  const int NUM_ENTRIES = 100000;
+  const int OPS_PER_THREAD = 500000;
+  unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+
+  std::cout << "\n========================================\n";
+  std::cout << "   CONCURRENT MAP BENCHMARK\n";
+  std::cout << "   ConcurrentRobinHoodMap, 16 shards vs 1\n";
+  std::cout << "   " << NUM_ENTRIES << " entries, " << OPS_PER_THREAD
+            << " ops/thread, hardware_concurrency " << hw << "\n";
+  std::cout << "========================================\n\n";
+
+  std::vector<Coord> keys(NUM_ENTRIES);
+  for (int i = 0; i < NUM_ENTRIES; ++i) {
+    keys[i] = {i * 7 + 13, i * 3 - 500};
+  }
+
+  std::vector<unsigned> counts;
+  for (unsigned t = 1; t < hw; t *= 2)
+    counts.push_back(t);
+  counts.push_back(hw);
+
+  std::cout << std::fixed << std::setprecision(2);
+  for (int write_pct : {0, 10, 50}) {
+    std::cout << "--- " << (100 - write_pct) << "% reads / " << write_pct
+              << "% writes (Mops/s) ---\n";
+    std::cout << "  threads   16 shards    1 shard\n";
+    for (unsigned t : counts) {
+      double sharded = concurrent_mops<16>(keys, t, OPS_PER_THREAD, write_pct);
+      double global = concurrent_mops<1>(keys, t, OPS_PER_THREAD, write_pct);
+      std::cout << "  " << std::setw(7) << t << std::setw(12) << sharded
+                << std::setw(11) << global << "\n";
+    }
+    std::cout << "\n";
+  }
+  std::cout << std::defaultfloat << std::setprecision(6);
+}
+
+// ============================================================================
+//  Visited Set Benchmark: RobinHoodMap<Coord, Coord> vs RobinHoodSet<Coord>
+// ============================================================================
+//
+//  The old BFS visited pattern — count() then try_emplace(key, parent) —
+//  against one RobinHoodSet::insert() per cell. Cells come from random
+//  walks over a small area, so most checks hit an already-visited cell,
+//  as in a search frontier.
+//
+// ============================================================================
+
+inline void run_visited_set_benchmark() {
+  const int WALKS = 200;
+  const int STEPS = 5000;
+
+  std::cout << "\n========================================\n";
+  std::cout << "   VISITED SET BENCHMARK\n";
+  std::cout << "   RobinHoodMap count+try_emplace vs RobinHoodSet insert\n";
+  std::cout << "   " << WALKS << " walks x " << STEPS << " steps\n";
+  std::cout << "========================================\n\n";
+
+  std::mt19937 rng(99);
+  std::vector<Coord> cells;
+  cells.reserve(static_cast<size_t>(WALKS) * STEPS);
+  for (int w = 0; w < WALKS; ++w) {
+    Coord c = {0, 0};
+    for (int i = 0; i < STEPS; ++i) {
+      c.x += static_cast<int>(rng() % 3) - 1;
+      c.y += static_cast<int>(rng() % 3) - 1;
+      cells.push_back(c);
+    }
+  }
+
+  volatile size_t sink = 0;
+  auto time_us = [&](auto &&pass) {
+    auto t1 = std::chrono::high_resolution_clock::now();
+    pass();
+    auto t2 = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1)
+        .count();
+  };
+
+  long long map_us = time_us([&] {
+    size_t fresh = 0;
+    for (size_t w = 0; w < cells.size(); w += STEPS) {
+      RobinHoodMap<Coord, Coord, CoordHash> parent;
+      for (size_t i = w; i < w + STEPS; ++i) {
+        if (parent.count(cells[i]))
+          continue;
+        parent.try_emplace(cells[i], cells[i]);
+        ++fresh;
+      }
+    }
+    sink = fresh;
+  });
+  long long set_us = time_us([&] {
+    size_t fresh = 0;
+    for (size_t w = 0; w < cells.size(); w += STEPS) {
+      RobinHoodSet<Coord, CoordHash> visited;
+      for (size_t i = w; i < w + STEPS; ++i)
+        fresh += visited.insert(cells[i]).second;
+    }
+    sink = fresh;
+  });
+  (void)sink;
+
+  std::cout << "  Bytes/slot:   map " << 2 * sizeof(Coord) + 1 << ", set "
+            << sizeof(Coord) + 1 << "\n";
+  std::cout << "  Map (2 probes on a miss): " << map_us << " us\n";
+  std::cout << "  Set (1 probe):            " << set_us << " us\n";
+  std::cout << "  Speedup: "
+            << static_cast<double>(map_us) / static_cast<double>(set_us)
+            << "x\n";
+}
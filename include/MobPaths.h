@@ -0,0 +1,178 @@
+#pragma once
+#include "Coord.h"
+#include "MoveMasks.h"
+#include "World.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <optional>
+#include <vector>
+
+// ============================================================================
+//  MobPaths — Each Mob's Planned Path, Kept Between Mob Ticks
+// ============================================================================
+//
+//  Sits next to MobStorage, index for index (add/remove in step with it),
+//  and holds what a mob decided last time it searched:
+//
+//  - moves  the PATH_DIRS index of every step left, one byte each; empty
+//           when the search found no way to the target
+//  - at     the cell the next move starts from
+//  - goal   where the target was when the path was planned
+//  - epoch  World::edit_epoch() when it was planned or last checked
+//
+//  A plan is reused while the mob still stands at `at`, the target is
+//  within a threshold (Chebyshev) of `goal`, and either the world's edit
+//  epoch hasn't moved or every move left still passes its cell's move
+//  mask. A mask covers exactly the cells a move depends on (its target
+//  and the support beside or under it), so an edit anywhere else, or a
+//  chunk arriving far away, costs one byte read per remaining step
+//  instead of a new search. A mob on the target keeps its empty plan
+//  through any edit; a search that found nothing can't be checked move by
+//  move and is only reused while the epoch holds.
+//
+//  hits counts mob ticks served from a plan; misses counts plans made.
+//  A hit is a plan not made, not a search avoided: the mobs that replan
+//  in one tick share a single flow field, so GameWindow counts its
+//  saving in field builds.
+//
+// ============================================================================
+
+struct MobPaths {
+  static constexpr uint64_t NO_PLAN = UINT64_MAX;
+
+  std::vector<std::vector<uint8_t>> moves;
+  std::vector<uint16_t> next; // index into moves of the next step
+  std::vector<Coord> at;
+  std::vector<Coord> goal;
+  std::vector<uint64_t> epoch; // NO_PLAN until the first plan
+
+  size_t hits = 0;
+  size_t misses = 0;
+  size_t revalidations = 0; // hits that needed the mask check
+
+  void add() {
+    moves.emplace_back();
+    next.push_back(0);
+    at.push_back({0, 0});
+    goal.push_back({0, 0});
+    epoch.push_back(NO_PLAN);
+  }
+
+  void remove(size_t index) {
+    if (index >= moves.size())
+      return;
+    size_t last = moves.size() - 1;
+    if (index != last) {
+      moves[index].swap(moves[last]);
+      next[index] = next[last];
+      at[index] = at[last];
+      goal[index] = goal[last];
+      epoch[index] = epoch[last];
+    }
+    moves.pop_back();
+    next.pop_back();
+    at.pop_back();
+    goal.pop_back();
+    epoch.pop_back();
+  }
+
+  // Mobs added to MobStorage some other way (a loaded save) start unplanned
+  void resize(size_t n) {
+    while (moves.size() < n)
+      add();
+    while (moves.size() > n)
+      remove(moves.size() - 1);
+  }
+
+  size_t count() const { return moves.size(); }
+
+  // Whether mob i at pos may keep following its plan toward target.
+  // Counts a hit, or a miss the caller answers with plan().
+  bool reuse(size_t i, Coord pos, Coord target, World &world,
+             int threshold) {
+    bool ok = epoch[i] != NO_PLAN && at[i] == pos &&
+              std::max(std::abs(goal[i].x - target.x),
+                       std::abs(goal[i].y - target.y)) <= threshold;
+    if (ok && next[i] == moves[i].size()) {
+      // Standing on the target needs no search whatever changed; a path
+      // that ran out short of it, or found nothing, does
+      ok = pos == target ||
+           (moves[i].empty() && epoch[i] == world.edit_epoch());
+    } else if (ok && epoch[i] != world.edit_epoch()) {
+      ok = still_legal(i, world);
+      if (ok) {
+        epoch[i] = world.edit_epoch();
+        ++revalidations;
+      }
+    }
+    ++(ok ? hits : misses);
+    return ok;
+  }
+
+  // Record mob i's path from pos toward target: next_move(cell) gives the
+  // PATH_DIRS index of a shortest path's first move, nullopt at the target
+  // or where there is none. At most max_steps are kept.
+  template <typename NextMove>
+  void plan(size_t i, Coord pos, Coord target, uint64_t world_epoch,
+            NextMove &&next_move, size_t max_steps = 256) {
+    moves[i].clear();
+    next[i] = 0;
+    at[i] = pos;
+    goal[i] = target;
+    epoch[i] = world_epoch;
+    for (Coord c = pos; moves[i].size() < max_steps;) {
+      std::optional<uint8_t> m = next_move(c);
+      if (!m)
+        break;
+      moves[i].push_back(*m);
+      c = c + PATH_DIRS[*m];
+    }
+  }
+
+  // Record path (start first, as bfs_findpath returns it) as mob i's plan;
+  // an empty path is a search that found nothing
+  void plan_path(size_t i, Coord pos, Coord target, uint64_t world_epoch,
+                 const std::vector<Coord> &path, size_t max_steps = 256) {
+    size_t k = 0;
+    plan(
+        i, pos, target, world_epoch,
+        [&](Coord c) -> std::optional<uint8_t> {
+          if (++k >= path.size())
+            return std::nullopt;
+          for (uint8_t m = 0; m < 8; ++m) {
+            if (c + PATH_DIRS[m] == path[k])
+              return m;
+          }
+          return std::nullopt;
+        },
+        max_steps);
+  }
+
+  // Take mob i's next step; nullopt if its plan is to stay put
+  std::optional<Coord> advance(size_t i) {
+    if (next[i] >= moves[i].size())
+      return std::nullopt;
+    at[i] = at[i] + PATH_DIRS[moves[i][next[i]++]];
+    return at[i];
+  }
+
+  double hit_rate() const {
+    size_t total = hits + misses;
+    return total ? static_cast<double>(hits) / total : 0.0;
+  }
+
+private:
+  bool still_legal(size_t i, World &world) const {
+    World::Cursor cursor(world);
+    Coord c = at[i];
+    for (size_t k = next[i]; k < moves[i].size(); ++k) {
+      uint8_t m = moves[i][k];
+      if (!((cursor.moves(c.x, c.y) >> m) & 1u))
+        return false;
+      c = c + PATH_DIRS[m];
+    }
+    return true;
+  }
+};
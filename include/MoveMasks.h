@@ -0,0 +1,197 @@
+#pragma once
+#include "Chunk.h"
+#include "Coord.h"
+#include "RobinHoodMap.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// The eight moves a mob may try, in the order searches try them
+inline constexpr Coord PATH_DIRS[8] = {{-1, 0},  {1, 0},  {0, 1},  {0, -1},
+                                       {-1, -1}, {1, -1}, {-1, 1}, {1, 1}};
+
+// Walk/climb/fall rules: may a mob at cur move by dir? The target must be
+// air; a diagonal climb needs solid beside cur to climb over, a straight
+// climb needs solid under cur to push off, and walking or stepping down
+// diagonally needs ground under the target. Falling straight down is
+// always allowed.
+template <typename IsAir>
+inline bool can_step(Coord cur, Coord dir, IsAir &&is_air) {
+  Coord nei = cur + dir;
+  if (!is_air(nei.x, nei.y))
+    return false;
+  if (dir.y == -1)
+    return dir.x != 0 ? !is_air(nei.x, cur.y) : !is_air(cur.x, cur.y + 1);
+  if (dir.y == 0 || dir.x != 0)
+    return !is_air(nei.x, nei.y + 1);
+  return true;
+}
+
+// Bit m set = can_step(cur, PATH_DIRS[m], is_air)
+template <typename IsAir>
+inline uint8_t move_mask(Coord cur, IsAir &&is_air) {
+  uint8_t mask = 0;
+  for (uint8_t m = 0; m < 8; ++m) {
+    if (can_step(cur, PATH_DIRS[m], is_air))
+      mask |= static_cast<uint8_t>(1u << m);
+  }
+  return mask;
+}
+
+// ============================================================================
+//  MoveMaskIndex — Legal Moves per Cell, Kept Current Across Edits
+// ============================================================================
+//
+//  One byte per cell of every resident chunk: its move_mask, as a search
+//  that treats unloaded chunks as solid sees it. A search then reads one
+//  byte per expansion and walks its set bits instead of asking can_step
+//  for up to three cells per direction.
+//
+//  The rules for a cell read the column either side of it, the row above
+//  and the two rows below. So a cell flipping between air and solid
+//  changes the masks of a 3 x 4 block around it (one row below, two
+//  above), and a chunk arriving or leaving changes its own masks and the
+//  same rim of its neighbours'. Each update re-reads the solidity rows
+//  under the block it recomputes, one chunk lookup per row span.
+//
+//  Cells of chunks that have no table (shared uniform sky and bedrock,
+//  chunks that aren't loaded) are computed on request instead.
+//
+//  The World owns one and keeps it current; like ReachabilityIndex it is
+//  idle until the first query.
+//
+// ============================================================================
+
+class MoveMaskIndex {
+  static constexpr int CELLS = CHUNK_SIZE * CHUNK_SIZE;
+
+  bool active_ = false;
+  RobinHoodMap<Coord, std::vector<uint8_t>, CoordHash> chunks_;
+  // Solidity of the window being recomputed, one row per entry, bit
+  // (x - win_x_) = solid. Cells of chunks that aren't loaded are solid.
+  std::vector<uint64_t> win_;
+  int win_x_ = 0, win_y_ = 0;
+  size_t recomputed_ = 0;
+
+  static int floor_div(int v) {
+    return v >= 0 ? v / CHUNK_SIZE : (v - CHUNK_SIZE + 1) / CHUNK_SIZE;
+  }
+
+  // Read what the masks of [x0, x1] x [y0, y1] depend on into win_.
+  // chunk_at(cp) is the chunk a search reads at cp, nullptr if none.
+  template <typename ChunkAt>
+  void load_window(int x0, int y0, int x1, int y1, ChunkAt &&chunk_at) {
+    win_x_ = x0 - 1;
+    win_y_ = y0 - 1;
+    int w = x1 - x0 + 3, h = y1 - y0 + 4;
+    win_.assign(static_cast<size_t>(h), 0);
+    for (int r = 0; r < h; ++r) {
+      int wy = win_y_ + r;
+      int cy = floor_div(wy), ly = wy - cy * CHUNK_SIZE;
+      for (int x = win_x_; x < win_x_ + w;) {
+        int cx = floor_div(x), lx = x - cx * CHUNK_SIZE;
+        int n = std::min(CHUNK_SIZE - lx, win_x_ + w - x);
+        uint64_t span = (uint64_t{1} << n) - 1;
+        uint64_t solid = span;
+        if (const Chunk *c = chunk_at(Coord{cx, cy}))
+          solid = (c->solid_row(ly) >> lx) & span;
+        win_[r] |= solid << (x - win_x_);
+        x += n;
+      }
+    }
+  }
+
+  uint8_t window_mask(Coord cur) const {
+    return move_mask(cur, [this](int x, int y) {
+      return !((win_[y - win_y_] >> (x - win_x_)) & 1u);
+    });
+  }
+
+  // Recompute every tabled cell in [x0, x1] x [y0, y1]
+  template <typename ChunkAt>
+  void refresh(int x0, int y0, int x1, int y1, ChunkAt &&chunk_at) {
+    load_window(x0, y0, x1, y1, chunk_at);
+    for (int cy = floor_div(y0); cy <= floor_div(y1); ++cy) {
+      for (int cx = floor_div(x0); cx <= floor_div(x1); ++cx) {
+        auto it = chunks_.find({cx, cy});
+        if (it == chunks_.end())
+          continue;
+        std::vector<uint8_t> &table = (*it).second;
+        int bx = cx * CHUNK_SIZE, by = cy * CHUNK_SIZE;
+        int ylo = std::max(y0, by), yhi = std::min(y1, by + CHUNK_SIZE - 1);
+        int xlo = std::max(x0, bx), xhi = std::min(x1, bx + CHUNK_SIZE - 1);
+        for (int y = ylo; y <= yhi; ++y) {
+          for (int x = xlo; x <= xhi; ++x)
+            table[(y - by) * CHUNK_SIZE + (x - bx)] = window_mask({x, y});
+        }
+        recomputed_ += static_cast<size_t>(yhi - ylo + 1) * (xhi - xlo + 1);
+      }
+    }
+  }
+
+  // Everything a chunk at cp arriving or leaving can change
+  template <typename ChunkAt>
+  void refresh_around(Coord cp, ChunkAt &&chunk_at) {
+    int bx = cp.x * CHUNK_SIZE, by = cp.y * CHUNK_SIZE;
+    refresh(bx - 1, by - 2, bx + CHUNK_SIZE, by + CHUNK_SIZE, chunk_at);
+  }
+
+public:
+  bool active() const { return active_; }
+
+  // Start tracking; the owner then reports every resident chunk
+  void activate() { active_ = true; }
+
+  // ---------------------------------------------------------------
+  //  Updates from the owning World (no-ops until activate()).
+  //  chunk_at must already reflect the change.
+  // ---------------------------------------------------------------
+
+  // Chunk now resident at pos (new, faulted in, or replacing another)
+  template <typename ChunkAt> void installed(Coord pos, ChunkAt &&chunk_at) {
+    if (!active_)
+      return;
+    (*chunks_.try_emplace(pos).first).second.assign(CELLS, 0);
+    refresh_around(pos, chunk_at);
+  }
+
+  template <typename ChunkAt> void removed(Coord pos, ChunkAt &&chunk_at) {
+    if (active_ && chunks_.erase(pos))
+      refresh_around(pos, chunk_at);
+  }
+
+  // Cell (wx, wy) changed between air and solid
+  template <typename ChunkAt>
+  void changed(int wx, int wy, ChunkAt &&chunk_at) {
+    if (active_)
+      refresh(wx - 1, wy - 2, wx + 1, wy + 1, chunk_at);
+  }
+
+  void clear() { chunks_.clear(); }
+
+  // ---------------------------------------------------------------
+  //  Queries
+  // ---------------------------------------------------------------
+
+  // The chunk's CHUNK_SIZE * CHUNK_SIZE masks, row-major, or nullptr if
+  // it has none. Stays valid until the chunk is removed or clear().
+  const uint8_t *table(Coord cp) const {
+    auto it = chunks_.find(cp);
+    return it == chunks_.end() ? nullptr : (*it).second.data();
+  }
+
+  // Mask of any cell, computed if its chunk has no table
+  template <typename ChunkAt> uint8_t mask(Coord cell, ChunkAt &&chunk_at) {
+    Coord cp = {floor_div(cell.x), floor_div(cell.y)};
+    if (const uint8_t *t = table(cp)) {
+      return t[(cell.y - cp.y * CHUNK_SIZE) * CHUNK_SIZE +
+               (cell.x - cp.x * CHUNK_SIZE)];
+    }
+    load_window(cell.x, cell.y, cell.x, cell.y, chunk_at);
+    return window_mask(cell);
+  }
+
+  size_t chunk_count() const { return chunks_.size(); }
+  size_t recompute_count() const { return recomputed_; } // cells
+};
@@ -0,0 +1,342 @@
+#pragma once
+#include "BlockType.h"
+#include "Terrain.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+// ============================================================================
+//  PackedBlocks — Palette-Indexed Block Storage for Chunks
+// ============================================================================
+//
+//  Each cell stores a small index into a palette instead of a full
+//  BlockType byte:
+//
+//  1. 4-bit indices (two cells per byte) while every block type in the chunk
+//     is below 16 — 512 bytes of cells instead of 1024 for a 32x32 chunk.
+//     The nibble palette is the identity (slot k holds BlockType k), so a
+//     cell decodes with a shift and a mask and set() never searches it;
+//     row spans decode in a loop the compiler vectorizes
+//  2. A chunk that needs a type past 15 widens to 8-bit indices into its own
+//     palette, so adding BlockTypes later never breaks storage
+//  3. Cells are row-major (index = y * CHUNK_SIZE + x), same order as the old
+//     std::array layout, so sequential scans stay sequential in memory
+//
+// ============================================================================
+
+// The nibble palette: slot k holds BlockType k
+inline constexpr std::array<BlockType, 16> NIBBLE_PALETTE_TYPES = [] {
+  std::array<BlockType, 16> pal{};
+  for (size_t i = 0; i < pal.size(); ++i)
+    pal[i] = static_cast<BlockType>(i);
+  return pal;
+}();
+
+class PackedBlocks {
+public:
+  static constexpr int CELLS = CHUNK_SIZE * CHUNK_SIZE;
+  static constexpr size_t NIBBLE_PALETTE = 16;
+
+private:
+  // 8-bit mode, only allocated for chunks that outgrow the nibble palette
+  struct Wide {
+    std::vector<BlockType> palette;
+    std::array<uint8_t, CELLS> index;
+  };
+
+  std::array<uint8_t, CELLS / 2> nibbles_{}; // low nibble = even cell; 0 = AIR
+  std::unique_ptr<Wide> wide_;
+
+  static bool fits_nibble(BlockType t) {
+    return static_cast<uint8_t>(t) < NIBBLE_PALETTE;
+  }
+
+  // Wide palette slot for 't', adding it if needed
+  int find_or_add(BlockType t) {
+    auto &pal = wide_->palette;
+    for (size_t i = 0; i < pal.size(); ++i) {
+      if (pal[i] == t)
+        return static_cast<int>(i);
+    }
+    pal.push_back(t);
+    return static_cast<int>(pal.size() - 1);
+  }
+
+  uint8_t nibble_at(int idx) const {
+    uint8_t b = nibbles_[idx >> 1];
+    return (idx & 1) ? static_cast<uint8_t>(b >> 4)
+                     : static_cast<uint8_t>(b & 0x0F);
+  }
+
+  void set_nibble(int idx, uint8_t p) {
+    uint8_t &b = nibbles_[idx >> 1];
+    if (idx & 1) {
+      b = static_cast<uint8_t>((b & 0x0F) | (p << 4));
+    } else {
+      b = static_cast<uint8_t>((b & 0xF0) | p);
+    }
+  }
+
+  // Bit k set = the k-th nibble of the 8 bytes at p is nonzero (low
+  // nibble of each byte first, as cells are stored)
+  static uint32_t nonzero_nibbles(const uint8_t *p) {
+    uint64_t x = 0;
+    for (int i = 0; i < 8; ++i)
+      x |= static_cast<uint64_t>(p[i]) << (8 * i);
+    x |= x >> 2;
+    x |= x >> 1;
+    x &= 0x1111111111111111ull;                 // bit 4k: nibble k
+    x = (x | x >> 3) & 0x0303030303030303ull;   // 2 per byte
+    x = (x | x >> 6) & 0x000F000F000F000Full;   // 4 per 16 bits
+    x = (x | x >> 12) & 0x000000FF000000FFull;  // 8 per 32 bits
+    return static_cast<uint32_t>((x | x >> 24) & 0xFFFF);
+  }
+
+  // Switch to 8-bit indices, keeping every cell's block type
+  void widen() {
+    auto w = std::make_unique<Wide>();
+    w->palette.assign(NIBBLE_PALETTE_TYPES.begin(), NIBBLE_PALETTE_TYPES.end());
+    for (int i = 0; i < CELLS; ++i) {
+      w->index[i] = nibble_at(i);
+    }
+    wide_ = std::move(w);
+  }
+
+public:
+  PackedBlocks() = default;
+
+  // Every cell set to fill
+  explicit PackedBlocks(BlockType fill) {
+    if (fits_nibble(fill)) {
+      uint8_t p = static_cast<uint8_t>(fill);
+      nibbles_.fill(static_cast<uint8_t>(p | (p << 4)));
+    } else {
+      set(0, fill);
+      for (int i = 1; i < CELLS; ++i)
+        wide_->index[i] = wide_->index[0];
+    }
+  }
+
+  explicit PackedBlocks(
+      const std::array<std::array<BlockType, CHUNK_SIZE>, CHUNK_SIZE> &grid) {
+    assign(grid);
+  }
+
+  PackedBlocks(const PackedBlocks &o)
+      : nibbles_(o.nibbles_),
+        wide_(o.wide_ ? std::make_unique<Wide>(*o.wide_) : nullptr) {}
+
+  PackedBlocks &operator=(const PackedBlocks &o) {
+    if (this != &o) {
+      nibbles_ = o.nibbles_;
+      wide_ = o.wide_ ? std::make_unique<Wide>(*o.wide_) : nullptr;
+    }
+    return *this;
+  }
+
+  PackedBlocks(PackedBlocks &&) noexcept = default;
+  PackedBlocks &operator=(PackedBlocks &&) noexcept = default;
+
+  BlockType get(int idx) const {
+    if (wide_) [[unlikely]]
+      return wide_->palette[wide_->index[idx]];
+    return static_cast<BlockType>(nibble_at(idx));
+  }
+
+  void set(int idx, BlockType t) {
+    if (!wide_ && fits_nibble(t)) [[likely]] {
+      set_nibble(idx, static_cast<uint8_t>(t));
+      return;
+    }
+    if (!wide_)
+      widen();
+    wide_->index[idx] = static_cast<uint8_t>(find_or_add(t));
+  }
+
+  // Rebuild from a full byte grid (terrain generation, old save files)
+  void assign(
+      const std::array<std::array<BlockType, CHUNK_SIZE>, CHUNK_SIZE> &grid) {
+    wide_.reset();
+    bool narrow = true;
+    for (const auto &row : grid) {
+      for (BlockType t : row)
+        narrow &= fits_nibble(t);
+    }
+    if (!narrow) {
+      widen();
+      for (int y = 0; y < CHUNK_SIZE; ++y) {
+        for (int x = 0; x < CHUNK_SIZE; ++x)
+          set(y * CHUNK_SIZE + x, grid[y][x]);
+      }
+      return;
+    }
+    for (int y = 0; y < CHUNK_SIZE; ++y) {
+      for (int x = 0; x < CHUNK_SIZE; x += 2) {
+        nibbles_[(y * CHUNK_SIZE + x) >> 1] = static_cast<uint8_t>(
+            static_cast<uint8_t>(grid[y][x]) |
+            (static_cast<uint8_t>(grid[y][x + 1]) << 4));
+      }
+    }
+  }
+
+  // Decode n consecutive cells starting at idx, a byte pair at a time
+  void unpack_span(int idx, int n, BlockType *out) const {
+    if (wide_) {
+      for (int i = 0; i < n; ++i) {
+        out[i] = wide_->palette[wide_->index[idx + i]];
+      }
+      return;
+    }
+    int i = 0;
+    if ((idx & 1) && n > 0) {
+      out[i++] = static_cast<BlockType>(nibble_at(idx));
+    }
+    const uint8_t *__restrict src = nibbles_.data() + ((idx + i) >> 1);
+    BlockType *__restrict dst = out + i;
+    int pairs = (n - i) >> 1;
+    for (int j = 0; j < pairs; ++j) {
+      dst[2 * j] = static_cast<BlockType>(src[j] & 0x0F);
+      dst[2 * j + 1] = static_cast<BlockType>(src[j] >> 4);
+    }
+    i += 2 * pairs;
+    if (i < n) {
+      out[i] = static_cast<BlockType>(nibble_at(idx + i));
+    }
+  }
+
+  // Bit x set = cell (x, y) is anything but AIR. In nibble mode AIR is
+  // index 0, so a row's 16 index bytes fold to 32 bits with shifts and
+  // masks instead of decoding every cell.
+  uint32_t solid_row(int y) const {
+    static_assert(CHUNK_SIZE == 32, "a row is two 64-bit words of nibbles");
+    if (wide_) {
+      uint32_t bits = 0;
+      for (int x = 0; x < CHUNK_SIZE; ++x) {
+        bits |= static_cast<uint32_t>(get(y * CHUNK_SIZE + x) !=
+                                      BlockType::AIR)
+                << x;
+      }
+      return bits;
+    }
+    const uint8_t *row = nibbles_.data() + y * (CHUNK_SIZE / 2);
+    return nonzero_nibbles(row) | (nonzero_nibbles(row + 8) << 16);
+  }
+
+  std::array<std::array<BlockType, CHUNK_SIZE>, CHUNK_SIZE> unpack() const {
+    std::array<std::array<BlockType, CHUNK_SIZE>, CHUNK_SIZE> grid;
+    for (int y = 0; y < CHUNK_SIZE; ++y) {
+      unpack_span(y * CHUNK_SIZE, CHUNK_SIZE, grid[y].data());
+    }
+    return grid;
+  }
+
+  // ---------------------------------------------------------------
+  //  Raw access for save files: palette + packed index bytes
+  // ---------------------------------------------------------------
+  int index_bits() const { return wide_ ? 8 : 4; }
+
+  size_t palette_size() const {
+    return wide_ ? wide_->palette.size() : NIBBLE_PALETTE;
+  }
+
+  const BlockType *palette_data() const {
+    return wide_ ? wide_->palette.data() : NIBBLE_PALETTE_TYPES.data();
+  }
+
+  const uint8_t *index_data() const {
+    return wide_ ? wide_->index.data() : nibbles_.data();
+  }
+
+  size_t index_bytes() const { return wide_ ? CELLS : CELLS / 2; }
+
+  // Inverse of the accessors above. Rejects indices outside the palette.
+  // 4-bit data written with another palette (older saves kept one per
+  // chunk) is re-coded onto the identity palette.
+  bool load_packed(int bits, const BlockType *pal, size_t n,
+                   const uint8_t *data) {
+    if (bits == 4) {
+      if (n == 0 || n > NIBBLE_PALETTE)
+        return false;
+      for (int i = 0; i < CELLS / 2; ++i) {
+        if ((data[i] & 0x0F) >= n || (data[i] >> 4) >= n)
+          return false;
+      }
+      bool narrow = true;
+      for (size_t i = 0; i < n; ++i)
+        narrow &= fits_nibble(pal[i]);
+      wide_.reset();
+      if (!narrow) {
+        widen();
+        for (int i = 0; i < CELLS; ++i) {
+          uint8_t b = data[i >> 1];
+          set(i, pal[(i & 1) ? b >> 4 : b & 0x0F]);
+        }
+        return true;
+      }
+      uint8_t code[NIBBLE_PALETTE];
+      for (size_t i = 0; i < n; ++i)
+        code[i] = static_cast<uint8_t>(pal[i]);
+      for (int i = 0; i < CELLS / 2; ++i) {
+        nibbles_[i] = static_cast<uint8_t>(code[data[i] & 0x0F] |
+                                           (code[data[i] >> 4] << 4));
+      }
+      return true;
+    }
+    if (bits == 8) {
+      if (n == 0 || n > 256)
+        return false;
+      for (int i = 0; i < CELLS; ++i) {
+        if (data[i] >= n)
+          return false;
+      }
+      auto w = std::make_unique<Wide>();
+      w->palette.assign(pal, pal + n);
+      for (int i = 0; i < CELLS; ++i) {
+        w->index[i] = data[i];
+      }
+      wide_ = std::move(w);
+      return true;
+    }
+    return false;
+  }
+
+  // Heap + inline bytes owned by this store
+  size_t memory_bytes() const {
+    size_t bytes = sizeof(PackedBlocks);
+    if (wide_) {
+      bytes += sizeof(Wide) + wide_->palette.capacity() * sizeof(BlockType);
+    }
+    return bytes;
+  }
+};
+
+// Serialized form shared by save files and the chunk spill store:
+// uint8 index bits, uint16 palette size, palette bytes, packed index bytes
+inline void write_packed_blocks(std::ostream &f, const PackedBlocks &pb) {
+  uint8_t bits = static_cast<uint8_t>(pb.index_bits());
+  uint16_t npal = static_cast<uint16_t>(pb.palette_size());
+  f.write(reinterpret_cast<char *>(&bits), 1);
+  f.write(reinterpret_cast<char *>(&npal), 2);
+  f.write(reinterpret_cast<const char *>(pb.palette_data()), npal);
+  f.write(reinterpret_cast<const char *>(pb.index_data()),
+          static_cast<std::streamsize>(pb.index_bytes()));
+}
+
+inline bool read_packed_blocks(std::istream &f, PackedBlocks &pb) {
+  uint8_t bits;
+  uint16_t npal;
+  f.read(reinterpret_cast<char *>(&bits), 1);
+  f.read(reinterpret_cast<char *>(&npal), 2);
+  if (!f || npal > 256)
+    return false;
+
+  BlockType pal[256];
+  uint8_t idx[PackedBlocks::CELLS];
+  f.read(reinterpret_cast<char *>(pal), npal);
+  f.read(reinterpret_cast<char *>(idx),
+         bits == 8 ? PackedBlocks::CELLS : PackedBlocks::CELLS / 2);
+  return f && pb.load_packed(bits, pal, npal, idx);
+}
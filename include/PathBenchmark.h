@@ -0,0 +1,1160 @@
+#pragma once
+#include "AStar.h"
+#include "Coord.h"
+#include "FlowField.h"
+#include "MobPaths.h"
+#include "PathContext.h"
+#include "Pathfinding.h"
+#include "PortalGraph.h"
+#include "Terrain.h"
+#include "World.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <vector>
+
+// ============================================================================
+//  BFS Probe Benchmark: block decode vs solidity bitset
+// ============================================================================
+//
+//  Runs the same mob searches (standable cell to standable cell, surface
+//  or cave, 10-100 blocks apart, max depth 150) over 16 loaded chunks with
+//  two cell tests:
+//
+//  1. blocks — Cursor::try_get_block(x, y) == AIR (palette decode per test)
+//  2. bitset — Cursor::try_is_air(x, y), one bit of Chunk::solid_rows
+//
+//  Reports nodes expanded per second; the search itself is shared.
+//
+// ============================================================================
+
+inline void run_bfs_probe_benchmark() {
+  const int CHUNKS = 16;
+  const int SEARCHES = 2000;
+  const int MAX_DEPTH = 150;
+
+  std::cout << "\n========================================\n";
+  std::cout << "   BFS PROBE BENCHMARK\n";
+  std::cout << "   get_block == AIR vs solidity bitset\n";
+  std::cout << "   " << SEARCHES << " searches, depth " << MAX_DEPTH << "\n";
+  std::cout << "========================================\n\n";
+
+  World world;
+  for (int cx = 0; cx < CHUNKS; ++cx) {
+    world.get_chunk({cx, 0});
+  }
+
+  // Random cell a mob could stand on (air over solid) in column x,
+  // on the surface or in a cave
+  std::mt19937 rng(7);
+  auto standable = [&](int x) {
+    std::vector<int> ys;
+    for (int y = 0; y < CHUNK_SIZE - 1; ++y) {
+      if (world.is_air(x, y) && !world.is_air(x, y + 1))
+        ys.push_back(y);
+    }
+    return Coord{x, ys[rng() % ys.size()]};
+  };
+
+  const int SPAN = CHUNKS * CHUNK_SIZE;
+  std::vector<std::pair<Coord, Coord>> queries;
+  for (int i = 0; i < SEARCHES; ++i) {
+    int x0 = 100 + static_cast<int>(rng() % (SPAN - 200));
+    int dx = 10 + static_cast<int>(rng() % 91);
+    int x1 = (rng() & 1) ? x0 + dx : x0 - dx;
+    queries.push_back({standable(x0), standable(x1)});
+  }
+
+  auto run = [&](auto &&make_probe, size_t &nodes, size_t &found) {
+    nodes = found = 0;
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (auto [s, t] : queries) {
+      World::Cursor cursor(world);
+      size_t expanded = 0;
+      auto path =
+          bfs_search(s, t, make_probe(cursor), MAX_DEPTH, &expanded);
+      nodes += expanded;
+      found += !path.empty();
+    }
+    auto t2 = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1)
+        .count();
+  };
+
+  size_t block_nodes, block_found;
+  auto block_us = run(
+      [](World::Cursor &c) {
+        return [&c](int x, int y) {
+          return c.try_get_block(x, y) == BlockType::AIR;
+        };
+      },
+      block_nodes, block_found);
+
+  size_t bit_nodes, bit_found;
+  auto bit_us = run(
+      [](World::Cursor &c) {
+        return [&c](int x, int y) { return c.try_is_air(x, y) == true; };
+      },
+      bit_nodes, bit_found);
+
+  double block_rate = block_nodes / (block_us / 1e6);
+  double bit_rate = bit_nodes / (bit_us / 1e6);
+
+  std::cout << "--- get_block == AIR ---\n";
+  std::cout << "  Nodes expanded: " << block_nodes << " (" << block_found
+            << " paths found)\n";
+  std::cout << "  Time:           " << block_us << " us\n";
+  std::cout << "  Nodes/sec:      " << block_rate << "\n\n";
+
+  std::cout << "--- solidity bitset ---\n";
+  std::cout << "  Nodes expanded: " << bit_nodes << " (" << bit_found
+            << " paths found)\n";
+  std::cout << "  Time:           " << bit_us << " us\n";
+  std::cout << "  Nodes/sec:      " << bit_rate << "\n\n";
+
+  std::cout << "========================================\n";
+  std::cout << "   SUMMARY\n";
+  std::cout << "   BFS nodes/sec speedup: " << bit_rate / block_rate << "x\n";
+  std::cout << "========================================\n\n";
+}
+
+// ============================================================================
+//  Mob Tick Benchmark: bfs_findpath per mob vs one shared FlowField
+// ============================================================================
+//
+//  One mob tick as GameWindow runs it: every mob within 60 blocks of the
+//  player takes one step toward them. Per mob count the tick is timed both
+//  ways (best of 3), and every mob's path length is checked to match.
+//
+//  1. terrain — generated chunks, mobs on the surface. Steep ground splits
+//               it into small walkable pockets, so most searches fail fast.
+//  2. steps   — flat ground with a 1-block step every 7 columns: every mob
+//               reaches the player, the per-mob worst case.
+//
+//  Terrain pits bfs_findpath against build_flow_field, both over the
+//  World; steps gives bfs_search and build() the same lambda. Where the
+//  two lines cross is what GameWindow::FIELD_MIN_MOBS is set from.
+//
+// ============================================================================
+
+// find_path(mob) is one mob's own search; build_field(field) the shared one
+template <typename FindPath, typename BuildField>
+inline void report_mob_tick(const char *label,
+                            const std::vector<Coord> &all_mobs,
+                            FindPath &&find_path, BuildField &&build_field) {
+  auto best_us = [](auto &&tick) {
+    long long best = -1;
+    for (int r = 0; r < 3; ++r) {
+      auto t1 = std::chrono::high_resolution_clock::now();
+      tick();
+      auto t2 = std::chrono::high_resolution_clock::now();
+      long long us =
+          std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1)
+              .count();
+      if (best < 0 || us < best)
+        best = us;
+    }
+    return best;
+  };
+
+  std::cout << "--- " << label << " ---\n";
+  std::cout << "     mobs    per-mob BFS (us)   flow field (us)   speedup\n";
+  FlowField field;
+  for (size_t n : {1u, 10u, 100u, 1000u}) {
+    std::vector<Coord> bfs_next(n), field_next(n);
+
+    long long bfs_us = best_us([&] {
+      for (size_t i = 0; i < n; ++i) {
+        std::vector<Coord> path =
+            find_path(all_mobs[i]);
+        bfs_next[i] = path.size() >= 2 ? path[1] : all_mobs[i];
+      }
+    });
+    long long field_us = best_us([&] {
+      build_field(field);
+      for (size_t i = 0; i < n; ++i) {
+        std::optional<Coord> next = field.next_step(all_mobs[i]);
+        field_next[i] = next ? *next : all_mobs[i];
+      }
+    });
+
+    // Same distance everywhere (the step itself may differ among ties)
+    size_t reachable = 0, mismatched = 0;
+    for (size_t i = 0; i < n; ++i) {
+      std::vector<Coord> path = find_path(all_mobs[i]);
+      int bfs_len = path.empty() ? -1 : static_cast<int>(path.size()) - 1;
+      reachable += bfs_len >= 0;
+      mismatched += bfs_len != field.distance(all_mobs[i]);
+    }
+
+    std::cout << std::setw(9) << n << std::setw(19) << bfs_us
+              << std::setw(18) << field_us << std::setw(9) << std::fixed
+              << std::setprecision(1)
+              << static_cast<double>(bfs_us) /
+                     static_cast<double>(std::max(field_us, 1LL))
+              << "x" << std::defaultfloat << std::setprecision(6) << "  ("
+              << reachable << " reach the player)";
+    if (mismatched)
+      std::cout << "  " << mismatched << " path lengths differ!";
+    std::cout << "\n";
+  }
+  std::cout << "  Field: " << field.reached_count() << " of "
+            << (2 * FlowField::DEFAULT_RADIUS + 1) *
+                   (2 * FlowField::DEFAULT_RADIUS + 1)
+            << " window cells reached\n\n";
+}
+
+inline void run_mob_tick_benchmark() {
+  const int CHUNKS = 16;
+  const int RADIUS = 60;
+
+  std::cout << "\n========================================\n";
+  std::cout << "   MOB TICK BENCHMARK\n";
+  std::cout << "   bfs_findpath per mob vs shared FlowField\n";
+  std::cout << "========================================\n\n";
+
+  std::mt19937 rng(11);
+  std::vector<int> offsets(1000);
+  for (int &dx : offsets)
+    dx = static_cast<int>(rng() % (2 * RADIUS + 1)) - RADIUS;
+
+  World world;
+  for (int cx = 0; cx < CHUNKS; ++cx) {
+    world.get_chunk({cx, 0});
+  }
+  // Topmost standable cell (air over solid) of column x
+  auto surface = [&](int x) {
+    int y = 0;
+    while (y < CHUNK_SIZE - 1 && world.is_air(x, y + 1))
+      ++y;
+    return Coord{x, y};
+  };
+  Coord player = surface(CHUNKS * CHUNK_SIZE / 2);
+  std::vector<Coord> mobs;
+  for (int dx : offsets)
+    mobs.push_back(surface(player.x + dx));
+  report_mob_tick(
+      "terrain", mobs,
+      [&](Coord start) {
+        return bfs_findpath(start, player, world, FlowField::DEFAULT_MAX_DEPTH);
+      },
+      [&](FlowField &field) { build_flow_field(field, player, world); });
+
+  // Ground at y = 20, one block higher on every other 7-column stretch
+  auto step_air = [](int x, int y) {
+    int ground = 20 - ((x >= 0 ? x : -x) / 7) % 2;
+    return y < ground;
+  };
+  auto stand = [&](int x) {
+    return Coord{x, 19 - ((x >= 0 ? x : -x) / 7) % 2};
+  };
+  player = stand(0);
+  mobs.clear();
+  for (int dx : offsets)
+    mobs.push_back(stand(dx));
+  report_mob_tick(
+      "steps", mobs,
+      [&](Coord start) {
+        return bfs_search(start, player, step_air,
+                          FlowField::DEFAULT_MAX_DEPTH);
+      },
+      [&](FlowField &field) { field.build(player, step_air); });
+}
+
+// ============================================================================
+//  Path Context Benchmark: bfs_search vs a reused PathContext
+// ============================================================================
+//
+//  Cave searches over 16 loaded chunks: start and target are standable
+//  cells with solid somewhere above them, 5-60 blocks apart, max depth
+//  150. bfs_search builds its queue, visited set and path per call;
+//  PathContext reuses one window grid, ring and path vector. Both must
+//  return the same path and expand the same nodes.
+//
+// ============================================================================
+
+inline void run_path_context_benchmark() {
+  const int CHUNKS = 16;
+  const int SEARCHES = 3000;
+  const int MAX_DEPTH = 150;
+
+  std::cout << "\n========================================\n";
+  std::cout << "   PATH CONTEXT BENCHMARK\n";
+  std::cout << "   bfs_search vs reused PathContext, caves\n";
+  std::cout << "   " << SEARCHES << " searches, depth " << MAX_DEPTH << "\n";
+  std::cout << "========================================\n\n";
+
+  World world;
+  for (int cx = 0; cx < CHUNKS; ++cx) {
+    world.get_chunk({cx, 0});
+  }
+
+  // Cave cells: air over solid with solid somewhere above, per column
+  const int SPAN = CHUNKS * CHUNK_SIZE;
+  std::vector<std::vector<int>> caves(SPAN);
+  for (int x = 0; x < SPAN; ++x) {
+    bool roofed = false;
+    for (int y = 0; y < CHUNK_SIZE - 1; ++y) {
+      if (!world.is_air(x, y))
+        roofed = true;
+      else if (roofed && !world.is_air(x, y + 1))
+        caves[x].push_back(y);
+    }
+  }
+  std::mt19937 rng(23);
+  auto cave_near = [&](int x) {
+    while (caves[x].empty())
+      ++x;
+    return Coord{x, caves[x][rng() % caves[x].size()]};
+  };
+  std::vector<std::pair<Coord, Coord>> queries;
+  for (int i = 0; i < SEARCHES; ++i) {
+    int x0 = 80 + static_cast<int>(rng() % (SPAN - 160));
+    int dx = 5 + static_cast<int>(rng() % 56);
+    int x1 = (rng() & 1) ? x0 + dx : x0 - dx;
+    queries.push_back({cave_near(x0), cave_near(x1)});
+  }
+
+  World::Cursor cursor(world);
+  auto probe = [&](int x, int y) { return cursor.try_is_air(x, y) == true; };
+
+  std::vector<std::vector<Coord>> expect(queries.size());
+  size_t nodes = 0, found = 0;
+  auto t1 = std::chrono::high_resolution_clock::now();
+  for (size_t i = 0; i < queries.size(); ++i) {
+    size_t expanded = 0;
+    expect[i] = bfs_search(queries[i].first, queries[i].second, probe,
+                           MAX_DEPTH, &expanded);
+    nodes += expanded;
+    found += !expect[i].empty();
+  }
+  auto t2 = std::chrono::high_resolution_clock::now();
+  long long old_us =
+      std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count();
+
+  PathContext ctx;
+  std::vector<Coord> path;
+  ctx.search(queries[0].first, queries[0].second, probe, MAX_DEPTH, path);
+  size_t ctx_nodes = 0, mismatched = 0;
+  t1 = std::chrono::high_resolution_clock::now();
+  for (size_t i = 0; i < queries.size(); ++i) {
+    size_t expanded = 0;
+    ctx.search(queries[i].first, queries[i].second, probe, MAX_DEPTH, path,
+               &expanded);
+    ctx_nodes += expanded;
+    mismatched += path != expect[i];
+  }
+  t2 = std::chrono::high_resolution_clock::now();
+  long long ctx_us =
+      std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count();
+
+  double old_rate = SEARCHES / (static_cast<double>(old_us) / 1e6);
+  double ctx_rate = SEARCHES / (static_cast<double>(ctx_us) / 1e6);
+  std::cout << "  " << found << " paths found, " << nodes
+            << " nodes expanded\n\n";
+  std::cout << "--- bfs_search ---\n";
+  std::cout << "  Time:         " << old_us << " us\n";
+  std::cout << "  Searches/sec: " << old_rate << "\n\n";
+  std::cout << "--- PathContext (warm, "
+            << ctx.reserved_bytes() / 1024 << " KB held) ---\n";
+  std::cout << "  Time:         " << ctx_us << " us\n";
+  std::cout << "  Searches/sec: " << ctx_rate << "\n";
+  if (mismatched || ctx_nodes != nodes)
+    std::cout << "  MISMATCH: " << mismatched << " paths, " << ctx_nodes
+              << " nodes\n";
+  std::cout << "\n  Speedup: " << ctx_rate / old_rate << "x\n";
+}
+
+// ============================================================================
+//  Reachability Benchmark: doomed searches vs the reachability index
+// ============================================================================
+//
+//  The player walls themselves in on stepped ground 16 chunks wide; mobs
+//  stand on the surface up to 90 blocks away and each tries to path to
+//  the player, depth 150. Compares:
+//
+//  1. bfs_search        — the search with no index, which floods every
+//                         cell it can reach before giving up
+//  2. bfs_findpath      — the same search behind World::may_reach
+//
+//  Then the cost an edit adds to the next query, with 16, 256 and 4096
+//  chunks resident, for a cell inside a chunk and one on its border.
+//  Opening a cell can only join components, and so can filling an inner
+//  cell that splits nothing: the edited chunk is relabelled and its links
+//  and its neighbours' united into the existing union-find. Filling a
+//  border cell may cut a crossing, so every component is renumbered and
+//  re-united from the stored links (no other chunk is relabelled or
+//  rescanned); that one grows with the resident count.
+//
+// ============================================================================
+
+inline void run_reachability_benchmark() {
+  const int CHUNKS = 16;
+  const int MOBS = 40;
+  const int TICKS = 5;
+  const int MAX_DEPTH = 150;
+  const int EDITS = 200;
+
+  std::cout << "\n========================================\n";
+  std::cout << "   REACHABILITY BENCHMARK\n";
+  std::cout << "   doomed searches, sealed player\n";
+  std::cout << "   " << MOBS << " mobs x " << TICKS << " ticks, depth "
+            << MAX_DEPTH << "\n";
+  std::cout << "========================================\n\n";
+
+  // Ground at y = 20, one block higher on every other 7-column stretch
+  // (the mob tick benchmark's "steps"), so a search that isn't doomed
+  // from the start roams the whole surface within its depth
+  World world;
+  for (int cx = 0; cx < CHUNKS; ++cx) {
+    std::array<std::array<BlockType, CHUNK_SIZE>, CHUNK_SIZE> grid;
+    for (int y = 0; y < CHUNK_SIZE; ++y) {
+      for (int x = 0; x < CHUNK_SIZE; ++x) {
+        int ground = 20 - ((cx * CHUNK_SIZE + x) / 7) % 2;
+        grid[y][x] = y < ground ? BlockType::AIR : BlockType::STONE;
+      }
+    }
+    world.load_chunk({cx, 0}, PackedBlocks(grid));
+  }
+  auto surface = [&](int x) {
+    int y = 0;
+    while (world.is_air(x, y + 1))
+      ++y;
+    return Coord{x, y};
+  };
+  Coord player = surface(CHUNKS * CHUNK_SIZE / 2);
+  for (int y = player.y - 1; y <= player.y + 1; ++y) {
+    for (int x = player.x - 1; x <= player.x + 1; ++x) {
+      if (Coord{x, y} != player)
+        world.set_block(x, y, BlockType::STONE);
+    }
+  }
+  std::vector<Coord> mobs;
+  for (int i = 0; i < MOBS; ++i) {
+    int dx = 5 + (i * 37) % 86;
+    mobs.push_back(surface(i % 2 ? player.x + dx : player.x - dx));
+  }
+
+  World::Cursor cursor(world);
+  auto probe = [&](int x, int y) { return cursor.try_is_air(x, y) == true; };
+
+  size_t nodes = 0, found = 0;
+  auto t1 = std::chrono::high_resolution_clock::now();
+  for (int t = 0; t < TICKS; ++t) {
+    for (Coord m : mobs) {
+      size_t expanded = 0;
+      found += !bfs_search(m, player, probe, MAX_DEPTH, &expanded).empty();
+      nodes += expanded;
+    }
+  }
+  auto t2 = std::chrono::high_resolution_clock::now();
+  long long bfs_us =
+      std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count();
+
+  world.may_reach(mobs[0], player); // index the resident chunks
+  t1 = std::chrono::high_resolution_clock::now();
+  for (int t = 0; t < TICKS; ++t) {
+    for (Coord m : mobs)
+      found += !bfs_findpath(m, player, world, MAX_DEPTH).empty();
+  }
+  t2 = std::chrono::high_resolution_clock::now();
+  long long idx_us =
+      std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count();
+
+  int searches = MOBS * TICKS;
+  std::cout << "  " << found << " paths found (expect 0), " << nodes
+            << " nodes expanded without the index\n\n";
+  std::cout << "--- bfs_search, no index ---\n";
+  std::cout << "  Time:       " << bfs_us << " us\n";
+  std::cout << "  Per search: " << static_cast<double>(bfs_us) / searches
+            << " us\n\n";
+  std::cout << "--- bfs_findpath + may_reach ---\n";
+  std::cout << "  Time:       " << idx_us << " us\n";
+  std::cout << "  Per search: " << static_cast<double>(idx_us) / searches
+            << " us\n\n";
+
+  // An edit's cost lands on the next query; opens and fills alternate
+  auto edit_cost = [&](World &w, Coord cell, const char *where) {
+    Coord far = {cell.x + 3, cell.y};
+    w.set_block(cell.x, cell.y, BlockType::STONE);
+    w.may_reach(far, cell);
+    long long ns[2] = {};
+    for (int i = 0; i < 2 * EDITS; ++i) {
+      auto e1 = std::chrono::high_resolution_clock::now();
+      w.set_block(cell.x, cell.y, i % 2 ? BlockType::STONE : BlockType::AIR);
+      w.may_reach(far, cell);
+      auto e2 = std::chrono::high_resolution_clock::now();
+      ns[i % 2] +=
+          std::chrono::duration_cast<std::chrono::nanoseconds>(e2 - e1)
+              .count();
+    }
+    std::cout << "  " << std::setw(4) << w.chunk_count() << " chunks, "
+              << where << ":  open "
+              << std::fixed << std::setprecision(1)
+              << ns[0] / 1000.0 / EDITS << " us, fill "
+              << ns[1] / 1000.0 / EDITS << " us" << std::defaultfloat
+              << std::setprecision(6) << "  ("
+              << w.reachability().component_count() << " components)\n";
+  };
+  std::cout << "--- edit + next query ---\n";
+  // In chunk 9, clear of the sealed player: column 8 and its last column
+  const int EDIT_X = 9 * CHUNK_SIZE;
+  edit_cost(world, {EDIT_X + 8, 2}, "inner ");
+  edit_cost(world, {EDIT_X + CHUNK_SIZE - 1, 2}, "border");
+  for (int n : {256, 4096}) {
+    World big;
+    for (int cx = 0; cx < n; ++cx) {
+      big.get_chunk({cx, 0});
+    }
+    edit_cost(big, {EDIT_X + 8, 2}, "inner ");
+    edit_cost(big, {EDIT_X + CHUNK_SIZE - 1, 2}, "border");
+  }
+  std::cout << "\n  Doomed search speedup: "
+            << static_cast<double>(bfs_us) / std::max(idx_us, 1LL) << "x\n";
+}
+
+// ============================================================================
+//  HPA Benchmark: plain BFS vs PortalGraph over 10-500 blocks
+// ============================================================================
+//
+//  Surface-to-surface searches over 24 loaded chunks with the trees
+//  felled, bucketed by horizontal distance; then again with stepped
+//  ridges every 64 columns that rise to y = 0, so a route over one climbs
+//  into the shared sky of chunk row -1. For each bucket:
+//
+//  1. BFS, depth 150  — bfs_search with bfs_findpath's usual cap
+//  2. BFS, uncapped   — the same search allowed to run to the end
+//  3. PortalGraph     — warm portal tables (the first pass over all
+//                       queries, which builds them, is timed separately)
+//
+//  Reports paths found, average path length and time per search, and how
+//  many paths PortalGraph found through the sky row. The uncapped BFS and
+//  PortalGraph should agree on every length.
+//
+// ============================================================================
+
+inline void run_hpa_benchmark() {
+  const int CHUNKS = 24;
+  const int PER_BUCKET = 20;
+  const int DISTANCES[] = {10, 50, 100, 250, 500};
+
+  std::cout << "\n========================================\n";
+  std::cout << "   HPA BENCHMARK\n";
+  std::cout << "   BFS vs chunk-portal A*, surface paths\n";
+  std::cout << "   " << PER_BUCKET << " searches per distance\n";
+  std::cout << "========================================\n\n";
+
+  World world;
+  for (int cx = 0; cx < CHUNKS; ++cx) {
+    world.get_chunk({cx, 0});
+  }
+  const int SPAN = CHUNKS * CHUNK_SIZE;
+  auto surface = [&](int x) {
+    int y = -1;
+    while (world.is_air(x, y + 1))
+      ++y;
+    return Coord{x, y};
+  };
+
+  // PortalGraph enters the resident chunks and the sky beside them; hold
+  // BFS to the same
+  World::Cursor cursor(world);
+  auto probe = [&](int x, int y) {
+    return x >= -CHUNK_SIZE && x < SPAN + CHUNK_SIZE && y >= -CHUNK_SIZE &&
+           y < CHUNK_SIZE && cursor.try_is_air(x, y) == true;
+  };
+
+  struct Result {
+    size_t found = 0, length = 0;
+    long long us = 0;
+  };
+  auto time_all = [](const std::vector<std::pair<Coord, Coord>> &q,
+                     auto &&search) {
+    Result r;
+    auto s1 = std::chrono::high_resolution_clock::now();
+    for (auto [s, t] : q) {
+      size_t len = search(s, t);
+      r.found += len != 0;
+      r.length += len;
+    }
+    auto s2 = std::chrono::high_resolution_clock::now();
+    r.us =
+        std::chrono::duration_cast<std::chrono::microseconds>(s2 - s1).count();
+    return r;
+  };
+  auto print = [](const char *name, const Result &r) {
+    std::cout << "  " << std::left << std::setw(16) << name << std::right
+              << std::setw(4) << r.found << " found" << std::setw(8)
+              << (r.found ? static_cast<double>(r.length) / r.found : 0.0)
+              << " avg len" << std::setw(10)
+              << static_cast<double>(r.us) / PER_BUCKET << " us/search\n";
+  };
+
+  auto run = [&](const char *terrain) {
+    std::mt19937 rng(31);
+    std::vector<std::vector<std::pair<Coord, Coord>>> buckets;
+    for (int d : DISTANCES) {
+      std::vector<std::pair<Coord, Coord>> q;
+      for (int i = 0; i < PER_BUCKET; ++i) {
+        int x0 = static_cast<int>(rng() % (SPAN - d));
+        if (rng() & 1)
+          q.push_back({surface(x0), surface(x0 + d)});
+        else
+          q.push_back({surface(x0 + d), surface(x0)});
+      }
+      buckets.push_back(std::move(q));
+    }
+
+    PortalGraph graph;
+    std::vector<Coord> path;
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (const auto &q : buckets) {
+      for (auto [s, t] : q)
+        graph.find_path(world, s, t, path);
+    }
+    auto t2 = std::chrono::high_resolution_clock::now();
+    std::cout << "=== " << terrain << " ===\n";
+    std::cout << "  Portal tables: " << graph.chunk_count() << " chunks, "
+              << graph.portal_count() << " portals, built in "
+              << std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1)
+                     .count()
+              << " us (first pass)\n\n";
+
+    size_t mismatched = 0, over_sky = 0;
+    for (size_t b = 0; b < buckets.size(); ++b) {
+      const auto &q = buckets[b];
+      Result capped = time_all(q, [&](Coord s, Coord t) {
+        return bfs_search(s, t, probe, 150).size();
+      });
+      std::vector<size_t> lengths;
+      Result full = time_all(q, [&](Coord s, Coord t) {
+        lengths.push_back(bfs_search(s, t, probe, 1 << 20).size());
+        return lengths.back();
+      });
+      size_t k = 0;
+      Result hpa = time_all(q, [&](Coord s, Coord t) {
+        graph.find_path(world, s, t, path);
+        mismatched += path.size() != lengths[k++];
+        over_sky += std::any_of(path.begin(), path.end(),
+                                [](Coord c) { return c.y < 0; });
+        return path.size();
+      });
+      std::cout << "--- " << DISTANCES[b] << " blocks ---\n";
+      print("BFS, depth 150", capped);
+      print("BFS, uncapped", full);
+      print("PortalGraph", hpa);
+      std::cout << "  Speedup vs uncapped BFS: "
+                << static_cast<double>(full.us) / std::max(hpa.us, 1LL)
+                << "x\n\n";
+    }
+    std::cout << "  Paths through the sky row: " << over_sky << "\n\n";
+    if (mismatched)
+      std::cout << "  MISMATCH: " << mismatched << " path lengths\n\n";
+  };
+
+  for (int x = 0; x < SPAN; ++x) {
+    for (int y = 0; y < CHUNK_SIZE; ++y) {
+      BlockType b = world.get_block(x, y);
+      if (b == BlockType::WOOD || b == BlockType::LEAF)
+        world.set_block(x, y, BlockType::AIR);
+    }
+  }
+  run("trees felled");
+  for (int x = 0; x < SPAN; ++x) {
+    int top = std::abs((x & 63) - 32); // one step a column, 0 at the peak
+    for (int y = top; y < CHUNK_SIZE && world.is_air(x, y); ++y)
+      world.set_block(x, y, BlockType::STONE);
+  }
+  run("ridges up to y = 0");
+}
+
+// ============================================================================
+//  A* Benchmark: bfs_findpath vs astar_findpath on generated terrain
+// ============================================================================
+//
+//  16 loaded chunks, depth 150. Every variant is the findpath a mob would
+//  call: the reachability check, then a search over the World's move
+//  masks.
+//
+//  1. trees  — surface cell to surface cell 10-100 blocks apart, a mob
+//              going after the player, trees standing. Trees cut the
+//              surface into short walks, so nearly every search fails
+//              after a few dozen nodes; A* can't beat BFS there
+//  2. chase  — the same with the trees felled, so surface walks connect
+//  3. mixed  — felled, and either end may be a cave cell where its
+//              column has one. Most of these fail on the reachability
+//              check (a sealed cave); a search that has to exhaust what
+//              it can reach costs A* as much as BFS plus its heap
+//
+//  Variants: BFS; A* CHEBYSHEV (exact, BFS-length paths); OCTILE
+//  (inadmissible under unit moves); CHEBYSHEV x2 (paths at most twice as
+//  long). Reports paths found, nodes expanded and microseconds per found
+//  and per failed query, average path length, and the total per query.
+//
+// ============================================================================
+
+inline void run_astar_benchmark() {
+  const int CHUNKS = 16;
+  const int SEARCHES = 1000;
+  const int MAX_DEPTH = 150;
+
+  std::cout << "\n========================================\n";
+  std::cout << "   A* BENCHMARK\n";
+  std::cout << "   bfs_findpath vs astar_findpath\n";
+  std::cout << "   " << SEARCHES << " searches, depth " << MAX_DEPTH << "\n";
+  std::cout << "========================================\n\n";
+
+  World world;
+  for (int cx = 0; cx < CHUNKS; ++cx) {
+    world.get_chunk({cx, 0});
+  }
+  const int SPAN = CHUNKS * CHUNK_SIZE;
+  // Standable cells per column, topmost (the surface) first
+  std::vector<std::vector<int>> stand(SPAN);
+  auto scan = [&] {
+    for (int x = 0; x < SPAN; ++x) {
+      stand[x].clear();
+      for (int y = 0; y < CHUNK_SIZE - 1; ++y) {
+        if (world.is_air(x, y) && !world.is_air(x, y + 1))
+          stand[x].push_back(y);
+      }
+    }
+  };
+
+  std::mt19937 rng(11);
+  auto make_queries = [&](bool caves) {
+    auto pick = [&](int x) {
+      return Coord{x, stand[x][caves ? rng() % stand[x].size() : 0]};
+    };
+    std::vector<std::pair<Coord, Coord>> queries;
+    for (int i = 0; i < SEARCHES; ++i) {
+      int x0 = 100 + static_cast<int>(rng() % (SPAN - 200));
+      int dx = 10 + static_cast<int>(rng() % 91);
+      int x1 = (rng() & 1) ? x0 + dx : x0 - dx;
+      queries.push_back({pick(x0), pick(x1)});
+    }
+    return queries;
+  };
+
+  World::Cursor cursor(world);
+  auto moves = [&](Coord c) { return cursor.moves(c.x, c.y); };
+  world.may_reach({0, 0}, {1, 0}); // index the resident chunks
+
+  // Failed searches expand everything they can reach whatever the
+  // heuristic, so found and failed are reported apart
+  auto report = [&](const char *name,
+                    const std::vector<std::pair<Coord, Coord>> &queries,
+                    auto &&search) {
+    size_t nodes[2] = {}, count[2] = {}, length = 0;
+    long long ns[2] = {};
+    for (auto [s, t] : queries) {
+      size_t expanded = 0;
+      auto t1 = std::chrono::high_resolution_clock::now();
+      std::vector<Coord> path;
+      if (world.may_reach(s, t))
+        path = search(s, t, &expanded);
+      auto t2 = std::chrono::high_resolution_clock::now();
+      int found = !path.empty();
+      nodes[found] += expanded;
+      ++count[found];
+      ns[found] +=
+          std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1)
+              .count();
+      length += path.size();
+    }
+    auto per = [](double total, size_t n) { return n ? total / n : 0.0; };
+    std::cout << "  " << std::left << std::setw(18) << name << std::right
+              << std::fixed << std::setprecision(1) << std::setw(6)
+              << count[1] << std::setw(9) << per(nodes[1], count[1])
+              << std::setw(9) << per(nodes[0], count[0]) << std::setw(7)
+              << per(length, count[1]) << std::setw(9)
+              << per(ns[1] / 1000.0, count[1]) << std::setw(9)
+              << per(ns[0] / 1000.0, count[0]) << std::setw(9)
+              << (ns[0] + ns[1]) / 1000.0 / queries.size()
+              << std::defaultfloat << std::setprecision(6) << "\n";
+  };
+
+  const char *SCENARIOS[] = {"trees", "chase", "mixed"};
+  for (int sc = 0; sc < 3; ++sc) {
+    if (sc == 1) { // fell the trees
+      for (int x = 0; x < SPAN; ++x) {
+        for (int y = 0; y < CHUNK_SIZE; ++y) {
+          BlockType b = world.get_block(x, y);
+          if (b == BlockType::WOOD || b == BlockType::LEAF)
+            world.set_block(x, y, BlockType::AIR);
+        }
+      }
+    }
+    scan();
+    std::vector<std::pair<Coord, Coord>> queries =
+        make_queries(sc == 2);
+    std::cout << "--- " << SCENARIOS[sc] << " ---\n";
+    std::cout << "  " << std::setw(24) << "found" << std::setw(9) << "nodes"
+              << std::setw(9) << "nodes" << std::setw(7) << "len"
+              << std::setw(9) << "us" << std::setw(9) << "us"
+              << std::setw(9) << "us" << "\n";
+    std::cout << "  " << std::setw(33) << "(found)" << std::setw(9)
+              << "(failed)" << std::setw(16) << "(found)" << std::setw(9)
+              << "(failed)" << std::setw(9) << "(all)" << "\n";
+    report("BFS", queries, [&](Coord s, Coord t, size_t *e) {
+      return bfs_search_masked(s, t, moves, MAX_DEPTH, e);
+    });
+    report("A* chebyshev", queries, [&](Coord s, Coord t, size_t *e) {
+      return astar_search_masked(s, t, moves, MAX_DEPTH,
+                                 Heuristic::CHEBYSHEV, 1.0f, e);
+    });
+    report("A* octile", queries, [&](Coord s, Coord t, size_t *e) {
+      return astar_search_masked(s, t, moves, MAX_DEPTH, Heuristic::OCTILE,
+                                 1.0f, e);
+    });
+    report("A* chebyshev x2", queries, [&](Coord s, Coord t, size_t *e) {
+      return astar_search_masked(s, t, moves, MAX_DEPTH,
+                                 Heuristic::CHEBYSHEV, 2.0f, e);
+    });
+    std::cout << "\n";
+  }
+}
+
+// ============================================================================
+//  Move Mask Benchmark: can_step per move vs a precomputed byte per cell
+// ============================================================================
+//
+//  The BFS probe benchmark's searches (standable cell to standable cell,
+//  10-100 blocks apart, depth 150, 16 generated chunks), with the trees
+//  felled so surface searches roam, expanded two ways:
+//
+//  1. can_step   — bfs_search over Cursor::try_is_air, up to three cell
+//                  tests per direction
+//  2. move masks — bfs_search_masked over Cursor::moves, one byte read
+//                  and a walk over its set bits
+//
+//  Both expand the same nodes. Then what the tables cost: building them
+//  for the resident chunks, and a set_block that flips a cell with the
+//  tables idle and kept current, inside a chunk and on a chunk border.
+//
+// ============================================================================
+
+inline void run_move_mask_benchmark() {
+  const int CHUNKS = 16;
+  const int SEARCHES = 2000;
+  const int MAX_DEPTH = 150;
+  const int EDITS = 100000;
+
+  std::cout << "\n========================================\n";
+  std::cout << "   MOVE MASK BENCHMARK\n";
+  std::cout << "   can_step vs per-cell move masks\n";
+  std::cout << "   " << SEARCHES << " searches, depth " << MAX_DEPTH << "\n";
+  std::cout << "========================================\n\n";
+
+  World world;
+  for (int cx = 0; cx < CHUNKS; ++cx) {
+    world.get_chunk({cx, 0});
+  }
+  const int SPAN = CHUNKS * CHUNK_SIZE;
+  for (int x = 0; x < SPAN; ++x) {
+    for (int y = 0; y < CHUNK_SIZE; ++y) {
+      BlockType b = world.get_block(x, y);
+      if (b == BlockType::WOOD || b == BlockType::LEAF)
+        world.set_block(x, y, BlockType::AIR);
+    }
+  }
+
+  std::mt19937 rng(7);
+  auto standable = [&](int x) {
+    std::vector<int> ys;
+    for (int y = 0; y < CHUNK_SIZE - 1; ++y) {
+      if (world.is_air(x, y) && !world.is_air(x, y + 1))
+        ys.push_back(y);
+    }
+    return Coord{x, ys[rng() % ys.size()]};
+  };
+  std::vector<std::pair<Coord, Coord>> queries;
+  for (int i = 0; i < SEARCHES; ++i) {
+    int x0 = 100 + static_cast<int>(rng() % (SPAN - 200));
+    int dx = 10 + static_cast<int>(rng() % 91);
+    int x1 = (rng() & 1) ? x0 + dx : x0 - dx;
+    queries.push_back({standable(x0), standable(x1)});
+  }
+
+  // Flip a cell to the other side of air/solid and back, EDITS times
+  auto edit_us = [&](Coord cell) {
+    BlockType was = world.get_block(cell.x, cell.y);
+    BlockType other = was == BlockType::AIR ? BlockType::STONE : BlockType::AIR;
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < EDITS; ++i)
+      world.set_block(cell.x, cell.y, i % 2 ? was : other);
+    auto t2 = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1)
+               .count() /
+           static_cast<double>(EDITS);
+  };
+  const Coord inner = {5 * CHUNK_SIZE + 12, 20};
+  const Coord border = {6 * CHUNK_SIZE, 20};
+  double idle_inner = edit_us(inner);
+  double idle_border = edit_us(border);
+
+  auto run = [&](auto &&search, size_t &nodes, size_t &found) {
+    nodes = found = 0;
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (auto [s, t] : queries) {
+      World::Cursor cursor(world);
+      size_t expanded = 0;
+      found += !search(cursor, s, t, &expanded).empty();
+      nodes += expanded;
+    }
+    auto t2 = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1)
+        .count();
+  };
+
+  size_t step_nodes, step_found;
+  auto step_us = run(
+      [&](World::Cursor &c, Coord s, Coord t, size_t *e) {
+        return bfs_search(
+            s, t, [&c](int x, int y) { return c.try_is_air(x, y) == true; },
+            MAX_DEPTH, e);
+      },
+      step_nodes, step_found);
+
+  auto b1 = std::chrono::high_resolution_clock::now();
+  world.move_mask({0, 0}); // table every resident chunk
+  auto b2 = std::chrono::high_resolution_clock::now();
+  long long build_us =
+      std::chrono::duration_cast<std::chrono::microseconds>(b2 - b1).count();
+
+  size_t mask_nodes, mask_found;
+  auto mask_us = run(
+      [&](World::Cursor &c, Coord s, Coord t, size_t *e) {
+        return bfs_search_masked(
+            s, t, [&c](Coord p) { return c.moves(p.x, p.y); }, MAX_DEPTH, e);
+      },
+      mask_nodes, mask_found);
+
+  double kept_inner = edit_us(inner);
+  double kept_border = edit_us(border);
+
+  double step_rate = step_nodes / (step_us / 1e6);
+  double mask_rate = mask_nodes / (mask_us / 1e6);
+
+  std::cout << "--- can_step ---\n";
+  std::cout << "  Nodes expanded: " << step_nodes << " (" << step_found
+            << " paths found)\n";
+  std::cout << "  Time:           " << step_us << " us\n";
+  std::cout << "  Nodes/sec:      " << step_rate << "\n\n";
+
+  std::cout << "--- move masks ---\n";
+  std::cout << "  Nodes expanded: " << mask_nodes << " (" << mask_found
+            << " paths found)\n";
+  std::cout << "  Time:           " << mask_us << " us\n";
+  std::cout << "  Nodes/sec:      " << mask_rate << "\n";
+  std::cout << "  Tables:         " << world.move_masks().chunk_count()
+            << " chunks, " << world.move_masks().chunk_count() * CHUNK_SIZE *
+                                  CHUNK_SIZE / 1024
+            << " KB, built in " << build_us << " us\n\n";
+
+  std::cout << "--- set_block flipping air/solid ---\n";
+  std::cout << "  In a chunk, tables idle:    " << idle_inner << " ns\n";
+  std::cout << "  In a chunk, tables kept:    " << kept_inner << " ns\n";
+  std::cout << "  Chunk border, tables idle:  " << idle_border << " ns\n";
+  std::cout << "  Chunk border, tables kept:  " << kept_border << " ns\n";
+  std::cout << "\n========================================\n";
+  std::cout << "   SUMMARY\n";
+  std::cout << "   BFS nodes/sec speedup: " << mask_rate / step_rate << "x\n";
+  std::cout << "========================================\n\n";
+}
+
+// ============================================================================
+//  Path Cache Benchmark: a plan every mob tick vs cached mob paths
+// ============================================================================
+//
+//  GameWindow's mob tick over 1200 ticks (10 min of play) on the stepped
+//  ground of the reachability benchmark: 20 mobs (about what spawning
+//  keeps around in play) and 200, within 50 blocks of a player who runs back and forth over 120 blocks, one block a tick, so
+//  the mobs are still chasing at the end instead of piled on a standing
+//  player. Every tick also mines or fills one cell underground somewhere
+//  in the 16 chunks, and every 10th tick a block is dropped (or taken
+//  away) just behind the player, where the chasing mobs' paths run.
+//
+//  1. no cache  — every grounded mob plans every tick: one flow field,
+//                 or a bfs_findpath each below FIELD_MIN_MOBS
+//  2. MobPaths  — a mob replans only when its plan is stale, by the same
+//                 rule among the mobs that do
+//
+//  Searches avoided are counted as GameWindow counts them: below
+//  FIELD_MIN_MOBS planning mobs a reused plan skips one bfs_findpath;
+//  at or above it a tick skips one field build if it builds none (there
+//  is at most one per tick, however many plans are reused). Also reports
+//  field builds and per-mob searches actually run, the hit rate, mask
+//  revalidations, time per tick and the mean distance from mob to player
+//  over the run.
+//
+// ============================================================================
+
+inline void run_path_cache_benchmark() {
+  const int CHUNKS = 16;
+  const int TICKS = 1200;
+  const float TICK_MS = 500.0f;      // GameWindow::MOB_MOVE_MS
+  const int REPLAN_DIST = 3;         // GameWindow::PATH_REPLAN_DIST
+  const size_t FIELD_MIN_MOBS = 32;  // GameWindow::FIELD_MIN_MOBS
+  const int RUN = 60;                // player runs +-RUN around the start
+
+  std::cout << "\n========================================\n";
+  std::cout << "   PATH CACHE BENCHMARK\n";
+  std::cout << "   plan every tick vs MobPaths\n";
+  std::cout << "   20 and 200 mobs x " << TICKS << " ticks\n";
+  std::cout << "========================================\n\n";
+
+  struct Result {
+    long long us = 0;
+    size_t builds = 0;
+    size_t searches = 0;       // per-mob bfs_findpath calls
+    size_t searches_avoided = 0; // as GameWindow counts them
+    long long total_dist = 0;  // Chebyshev, mob to player, every tick
+  };
+
+  auto simulate = [&](bool cached, MobPaths &paths, int mob_count) {
+    World world;
+    for (int cx = 0; cx < CHUNKS; ++cx) {
+      std::array<std::array<BlockType, CHUNK_SIZE>, CHUNK_SIZE> grid;
+      for (int y = 0; y < CHUNK_SIZE; ++y) {
+        for (int x = 0; x < CHUNK_SIZE; ++x) {
+          int ground = 20 - ((cx * CHUNK_SIZE + x) / 7) % 2;
+          grid[y][x] = y < ground ? BlockType::AIR : BlockType::STONE;
+        }
+      }
+      world.load_chunk({cx, 0}, PackedBlocks(grid));
+    }
+    auto surface = [&](int x) {
+      int y = 0;
+      while (world.is_air(x, y + 1))
+        ++y;
+      return Coord{x, y};
+    };
+
+    std::mt19937 rng(5);
+    const int start_x = CHUNKS * CHUNK_SIZE / 2;
+    Coord player = surface(start_x);
+    std::vector<Coord> mobs;
+    for (int i = 0; i < mob_count; ++i) {
+      int dx = static_cast<int>(rng() % 101) - 50;
+      mobs.push_back(surface(player.x + dx));
+      paths.add();
+    }
+
+    Result r;
+    FlowField field;
+    std::vector<size_t> replanning;
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (int t = 0; t < TICKS; ++t) {
+      // Out to +RUN, back to -RUN, and out again
+      int phase = (t + RUN) % (4 * RUN);
+      player = surface(start_x + (phase < 2 * RUN ? phase - RUN
+                                                  : 3 * RUN - phase));
+      // Mining underground, or a block dropped in the player's way
+      int ex = t % 10 == 9 ? player.x - 3
+                           : static_cast<int>(rng() % (CHUNKS * CHUNK_SIZE));
+      int ey = t % 10 == 9 ? player.y
+                           : 22 + static_cast<int>(rng() % 8);
+      world.set_block(ex, ey,
+                      world.is_air(ex, ey) ? BlockType::STONE
+                                           : BlockType::AIR);
+
+      // The two passes of GameWindow's mob tick
+      replanning.clear();
+      size_t planning = 0, reused = 0;
+      bool would_build = false;
+      for (size_t i = 0; i < mobs.size(); ++i) {
+        Coord m = mobs[i];
+        if (world.try_is_air(m.x, m.y + 1) == true) {
+          mobs[i] = {m.x, m.y + 1};
+          continue;
+        }
+        ++planning;
+        if (cached && paths.reuse(i, m, player, world, REPLAN_DIST)) {
+          ++reused;
+          would_build |= !paths.moves[i].empty();
+          if (std::optional<Coord> next = paths.advance(i))
+            mobs[i] = *next;
+        } else {
+          replanning.push_back(i);
+        }
+      }
+      bool use_field = replanning.size() >= FIELD_MIN_MOBS;
+      bool built = false;
+      for (size_t i : replanning) {
+        Coord m = mobs[i];
+        if (!use_field) {
+          paths.plan_path(i, m, player, world.edit_epoch(),
+                          bfs_findpath(m, player, world,
+                                       FlowField::DEFAULT_MAX_DEPTH));
+          ++r.searches;
+        } else if (world.may_reach(m, player)) {
+          if (!built) {
+            build_flow_field(field, player, world);
+            built = true;
+            ++r.builds;
+          }
+          paths.plan(i, m, player, world.edit_epoch(),
+                     [&](Coord c) { return field.next_move(c); });
+        } else {
+          paths.plan(i, m, player, world.edit_epoch(),
+                     [](Coord) { return std::optional<uint8_t>(); });
+        }
+        if (std::optional<Coord> next = paths.advance(i))
+          mobs[i] = *next;
+      }
+      if (planning < FIELD_MIN_MOBS)
+        r.searches_avoided += reused;
+      else if (would_build && !built)
+        ++r.searches_avoided;
+
+      for (Coord m : mobs)
+        r.total_dist +=
+            std::max(std::abs(m.x - player.x), std::abs(m.y - player.y));
+    }
+    auto t2 = std::chrono::high_resolution_clock::now();
+    r.us =
+        std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count();
+    return r;
+  };
+
+  double play_s = TICKS * TICK_MS / 1000.0;
+  double speedup[2] = {};
+  for (int n : {20, 200}) {
+    MobPaths uncached, paths;
+    Result plain = simulate(false, uncached, n);
+    Result cache = simulate(true, paths, n);
+
+    auto common = [&](const Result &r) {
+      std::cout << "  Field builds:     " << r.builds << "\n";
+      std::cout << "  Per-mob searches: " << r.searches << "\n";
+      std::cout << "  Per tick:         " << static_cast<double>(r.us) / TICKS
+                << " us\n";
+      std::cout << "  Mean distance:    "
+                << static_cast<double>(r.total_dist) / (n * TICKS) << "\n";
+    };
+    std::cout << "--- " << n << " mobs, plan every tick ---\n";
+    common(plain);
+    std::cout << "\n--- " << n << " mobs, MobPaths ---\n";
+    common(cache);
+    std::cout << "  Hit rate:         " << paths.hit_rate() * 100.0 << "% ("
+              << paths.hits << " hits, " << paths.misses << " replans)\n";
+    std::cout << "  Revalidated:      " << paths.revalidations
+              << " hits after an edit\n";
+    std::cout << "  Searches avoided: " << cache.searches_avoided / play_s
+              << " per second of play\n\n";
+    speedup[n == 200] =
+        static_cast<double>(plain.us) / std::max(cache.us, 1LL);
+  }
+
+  std::cout << "========================================\n";
+  std::cout << "   SUMMARY\n";
+  std::cout << "   Mob tick speedup: " << speedup[0] << "x (20 mobs), "
+            << speedup[1] << "x (200 mobs)\n";
+  std::cout << "========================================\n\n";
+}
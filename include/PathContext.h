@@ -0,0 +1,187 @@
+#pragma once
+#include "Coord.h"
+#include "Pathfinding.h"
+#include "World.h"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// ============================================================================
+//  PathContext — Reusable, Allocation-Free BFS
+// ============================================================================
+//
+//  bfs_search with its scratch memory kept between calls. A search of
+//  depth d never leaves the (2d + 1)^2 square around its start (a move
+//  changes x and y by at most 1), so the context owns a grid of that
+//  window for the deepest search it has run, re-centred on each start:
+//
+//  1. stamp — per cell, the search generation that visited it. Bumping
+//             the generation clears every cell at once; the grid is only
+//             wiped when the 32-bit counter wraps.
+//  2. from  — per cell, the PATH_DIRS index of the move that reached it:
+//             the path is read back from the target one byte at a time.
+//  3. ring  — the FIFO of cells to expand, a power-of-two ring buffer.
+//             It doubles if a frontier ever outgrows it.
+//
+//  Once the grid and ring have grown to fit, searches allocate nothing;
+//  the path goes into a caller-owned vector that keeps its capacity.
+//  Same rules, order and result as bfs_search, node for node.
+//
+// ============================================================================
+
+class PathContext {
+  int radius_ = -1;       // deepest max_depth seen; sizes the grid
+  int width_ = 0;         // 2 * radius_ + 1
+  uint32_t gen_ = 0;
+  Coord origin_;          // world coord of grid cell (0, 0)
+
+  std::vector<uint32_t> stamp_;
+  std::vector<uint8_t> from_;
+  std::vector<Coord> ring_;
+  size_t head_ = 0, tail_ = 0; // ever-increasing; index with & mask
+
+  static constexpr size_t MIN_RING = 1024;
+
+  size_t cell(Coord c) const {
+    return static_cast<size_t>(c.y - origin_.y) * width_ +
+           static_cast<size_t>(c.x - origin_.x);
+  }
+
+  // Grow the grid if max_depth is the deepest yet (a shallower search uses
+  // the middle of it) and start a new generation
+  void prepare(Coord start, int max_depth) {
+    if (max_depth > radius_) {
+      radius_ = max_depth;
+      width_ = 2 * max_depth + 1;
+      size_t cells = static_cast<size_t>(width_) * width_;
+      stamp_.assign(cells, 0);
+      from_.resize(cells);
+      gen_ = 0;
+    }
+    if (ring_.empty())
+      ring_.resize(MIN_RING);
+    if (++gen_ == 0) {
+      std::fill(stamp_.begin(), stamp_.end(), 0u);
+      gen_ = 1;
+    }
+    origin_ = {start.x - radius_, start.y - radius_};
+    head_ = tail_ = 0;
+  }
+
+  void push(Coord c) {
+    if (tail_ - head_ == ring_.size()) {
+      // Unroll into a ring twice the size, oldest first
+      std::vector<Coord> bigger(ring_.size() * 2);
+      size_t mask = ring_.size() - 1;
+      for (size_t i = head_; i != tail_; ++i)
+        bigger[i - head_] = ring_[i & mask];
+      tail_ -= head_;
+      head_ = 0;
+      ring_.swap(bigger);
+    }
+    ring_[tail_++ & (ring_.size() - 1)] = c;
+  }
+
+  Coord pop() { return ring_[head_++ & (ring_.size() - 1)]; }
+
+public:
+  // BFS from s to tar over can_step, up to max_depth moves. On success
+  // path holds s..tar and true is returned; otherwise path is empty.
+  // expanded (if given) receives the number of nodes popped.
+  template <typename IsAir>
+  bool search(Coord s, Coord tar, IsAir &&is_air, int max_depth,
+              std::vector<Coord> &path, size_t *expanded = nullptr) {
+    path.clear();
+    if (s == tar) {
+      if (expanded)
+        *expanded = 0;
+      path.push_back(s);
+      return true;
+    }
+    if (max_depth <= 0) {
+      if (expanded)
+        *expanded = 0;
+      return false;
+    }
+
+    prepare(s, max_depth);
+    stamp_[cell(s)] = gen_;
+    push(s);
+
+    int depth = 0;
+    int current_level_rem = 1;
+    int next_level_cnt = 0;
+    int found_depth = -1;
+
+    size_t popped = 0;
+    while (head_ != tail_ && depth < max_depth) {
+      Coord cur = pop();
+      ++popped;
+
+      if (cur == tar)
+        break;
+
+      for (uint8_t m = 0; m < 8; ++m) {
+        if (!can_step(cur, PATH_DIRS[m], is_air))
+          continue;
+        // depth < max_depth keeps nei inside the window
+        Coord nei = cur + PATH_DIRS[m];
+        size_t c = cell(nei);
+        if (stamp_[c] == gen_)
+          continue;
+        stamp_[c] = gen_;
+        from_[c] = m;
+
+        if (nei == tar)
+          found_depth = depth + 1;
+        push(nei);
+        ++next_level_cnt;
+      }
+
+      --current_level_rem;
+      if (current_level_rem == 0) {
+        depth++;
+        current_level_rem = next_level_cnt;
+        next_level_cnt = 0;
+      }
+    }
+
+    if (expanded)
+      *expanded = popped;
+    if (found_depth < 0)
+      return false;
+
+    // Walk back from the target, filling the path from its far end
+    path.resize(static_cast<size_t>(found_depth) + 1);
+    Coord cur = tar;
+    for (size_t i = path.size(); i-- > 1;) {
+      path[i] = cur;
+      cur = cur - PATH_DIRS[from_[cell(cur)]];
+    }
+    assert(cur == s);
+    path[0] = s;
+    return true;
+  }
+
+  // Bytes held by the grid and ring (what a warm context keeps)
+  size_t reserved_bytes() const {
+    return stamp_.capacity() * sizeof(uint32_t) + from_.capacity() +
+           ring_.capacity() * sizeof(Coord);
+  }
+};
+
+// bfs_findpath through a reusable context: same cell test, same result,
+// written into path
+inline bool bfs_findpath(PathContext &ctx, Coord s, Coord tar, World &world,
+                         int max_depth, std::vector<Coord> &path) {
+  if (!world.may_reach(s, tar)) {
+    path.clear();
+    return false;
+  }
+  World::Cursor cursor(world);
+  return ctx.search(
+      s, tar, [&](int x, int y) { return cursor.try_is_air(x, y) == true; },
+      max_depth, path);
+}
@@ -1,76 +1,91 @@
 #pragma once
 #include "BlockType.h"
 #include "Coord.h"
-#include "RobinHoodMap.h"
+#include "MoveMasks.h"
+#include "RobinHoodSet.h"
 #include "World.h"
-#include <queue>
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
-inline std::vector<Coord> bfs_findpath(Coord s, Coord tar, World &world,
-                                       int max_depth = 80) {
+// The neighbour generator every forward search shares: fn(m, nei) for
+// each legal move from cur, in PATH_DIRS order (m is the PATH_DIRS index)
+template <typename IsAir, typename Fn>
+inline void for_each_step(Coord cur, IsAir &&is_air, Fn &&fn) {
+  for (uint8_t m = 0; m < 8; ++m) {
+    if (can_step(cur, PATH_DIRS[m], is_air))
+      fn(m, cur + PATH_DIRS[m]);
+  }
+}
+
+// for_each_step from cur's move_mask: the set bits, lowest (first in
+// PATH_DIRS order) first
+template <typename Fn>
+inline void for_each_move(Coord cur, uint8_t mask, Fn &&fn) {
+  for (; mask; mask &= static_cast<uint8_t>(mask - 1)) {
+    uint8_t m = static_cast<uint8_t>(std::countr_zero(mask));
+    fn(m, cur + PATH_DIRS[m]);
+  }
+}
+
+// BFS over a move generator: steps(cur, fn) calls fn(m, nei) for each
+// legal move from cur, in PATH_DIRS order. expanded (if given) receives
+// the number of nodes popped.
+template <typename Steps>
+inline std::vector<Coord> bfs_search_steps(Coord s, Coord tar, Steps &&steps,
+                                           int max_depth = 80,
+                                           size_t *expanded = nullptr) {
 
   if (s == tar) {
+    if (expanded)
+      *expanded = 0;
     return {s};
   }
 
-  std::queue<Coord> qq;
-  qq.push(s);
-
-  RobinHoodMap<Coord, Coord, CoordHash> parent;
-  parent[s] = s;
+  // The queue is a vector that is never popped: each node keeps the index
+  // of the node that reached it, so the path is read back through those
+  // indices and the visited set needs keys only
+  struct Node {
+    Coord pos;
+    int parent;
+  };
+  std::vector<Node> nodes;
+  nodes.reserve(256);
+  nodes.push_back({s, -1});
+  size_t head = 0;
+  int found = -1;
+
+  RobinHoodSet<Coord, CoordHash> visited;
+  visited.reserve(256);
+  visited.insert(s);
 
   int depth = 0;
   int current_level_rem = 1;
   int next_level_cnt = 0;
 
-  const Coord dirs[] = {{-1, 0},  {1, 0},  {0, 1},  {0, -1},
-                        {-1, -1}, {1, -1}, {-1, 1}, {1, 1}};
-
-  while (!qq.empty() and depth < max_depth) {
-    Coord cur = qq.front();
-    qq.pop();
+  size_t popped = 0;
+  while (head < nodes.size() and depth < max_depth) {
+    int cur_idx = static_cast<int>(head++);
+    Coord cur = nodes[cur_idx].pos;
+    ++popped;
 
     if (cur == tar) {
       break;
     }
 
-    for (const Coord &dir : dirs) {
-      Coord nei = cur + dir;
-
-      if (parent.count(nei))
-        continue;
-
-      if (world.get_block(nei.x, nei.y) != BlockType::AIR)
-        continue;
-
-      if (dir.y == -1 and dir.x != 0) {
-        if (world.get_block(cur.x + dir.x, cur.y) == BlockType::AIR) {
-          continue;
-        }
-      }
-
-      if (dir.y == -1 and dir.x == 0) {
-        if (world.get_block(cur.x, cur.y + 1) == BlockType::AIR) {
-          continue;
-        }
-      }
-
-      if (dir.y == 0) {
-        if (world.get_block(nei.x, nei.y + 1) == BlockType::AIR) {
-          continue;
-        }
-      }
-
-      if (dir.y == 1 and dir.x != 0) {
-        if (world.get_block(nei.x, nei.y + 1) == BlockType::AIR) {
-          continue;
-        }
-      }
-
-      parent[nei] = cur;
-      qq.push(nei);
+    steps(cur, [&](uint8_t, Coord nei) {
+      // Checked last: the rules are cheaper than a probe, and
+      // check-and-insert is the same single probe
+      if (!visited.insert(nei).second)
+        return;
+
+      if (nei == tar)
+        found = static_cast<int>(nodes.size());
+      nodes.push_back({nei, cur_idx});
       ++next_level_cnt;
-    }
+    });
 
     --current_level_rem;
     if (current_level_rem == 0) {
@@ -80,18 +95,54 @@ inline std::vector<Coord> bfs_findpath(Coord s, Coord tar, World &world,
     }
   }
 
-  if (!parent.count(tar)) {
+  if (expanded)
+    *expanded = popped;
+
+  if (found < 0) {
     return {};
   }
 
   std::vector<Coord> path;
-  Coord cur = tar;
-  while (cur != s) {
-    path.push_back(cur);
-    cur = parent[cur];
-  }
-  path.push_back(s);
+  for (int i = found; i >= 0; i = nodes[i].parent)
+    path.push_back(nodes[i].pos);
   std::reverse(path.begin(), path.end());
 
   return path;
 }
+
+// BFS over can_step. is_air(x, y) answers the only question the search
+// asks about a cell.
+template <typename IsAir>
+inline std::vector<Coord> bfs_search(Coord s, Coord tar, IsAir &&is_air,
+                                     int max_depth = 80,
+                                     size_t *expanded = nullptr) {
+  return bfs_search_steps(
+      s, tar,
+      [&](Coord cur, auto &&fn) { for_each_step(cur, is_air, fn); },
+      max_depth, expanded);
+}
+
+// The same BFS with each cell's moves read whole: moves(cur) returns
+// cur's move_mask. Same result as bfs_search, node for node.
+template <typename Moves>
+inline std::vector<Coord> bfs_search_masked(Coord s, Coord tar, Moves &&moves,
+                                            int max_depth = 80,
+                                            size_t *expanded = nullptr) {
+  return bfs_search_steps(
+      s, tar,
+      [&](Coord cur, auto &&fn) { for_each_move(cur, moves(cur), fn); },
+      max_depth, expanded);
+}
+
+// Never generates: cells in chunks that aren't loaded count as solid, so a
+// search can't grow the world. Each expansion reads one byte of the
+// World's move masks. A target sealed off from s fails on the
+// reachability index instead of after max_depth levels.
+inline std::vector<Coord> bfs_findpath(Coord s, Coord tar, World &world,
+                                       int max_depth = 80) {
+  if (!world.may_reach(s, tar))
+    return {};
+  World::Cursor cursor(world);
+  return bfs_search_masked(
+      s, tar, [&](Coord c) { return cursor.moves(c.x, c.y); }, max_depth);
+}
@@ -0,0 +1,397 @@
+#pragma once
+#include "Chunk.h"
+#include "Coord.h"
+#include "Pathfinding.h"
+#include "RobinHoodMap.h"
+#include "World.h"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+// ============================================================================
+//  PortalGraph — Hierarchical (HPA*) Paths over Chunk Portals
+// ============================================================================
+//
+//  Two levels, both over can_step:
+//
+//  1. abstract — a chunk's portals are its border cells that a
+//                move leaves the chunk from or lands on. Each portal keeps
+//                the cells it steps to in neighbouring chunks (cost 1),
+//                and the chunk keeps a portal x portal table of BFS
+//                distances inside the chunk. A* runs over portals, with
+//                the Chebyshev distance as heuristic (a move changes x and
+//                y by at most 1, so it never overestimates).
+//  2. concrete — each in-chunk leg of the abstract path is filled in by a
+//                BFS confined to that chunk.
+//
+//  Every path splits at its chunk crossings into in-chunk legs between
+//  portals, so the abstract graph holds every route and the result is as
+//  short as a BFS's. The graph sees the world as bfs_findpath does:
+//  chunks that aren't loaded are solid, and unstored sky is air, so a
+//  route over a tree top may leave chunk row 0. There is no depth cap; the
+//  search is bounded by the resident chunks and the shared sky chunks
+//  next to them (sky further out is only reachable along the top of
+//  unloaded chunks). Shared bedrock has no air and gets no entry.
+//
+//  A chunk's portals depend on its cells and on the two-cell rim of its
+//  neighbours that the move rules look at, so each entry remembers the
+//  solidity_version of those nine chunks. The first search to reach it
+//  after any of them changed (set_block, load, eviction) rebuilds it.
+//
+// ============================================================================
+
+class PortalGraph {
+  static constexpr uint16_t UNREACHED = 0xFFFF;
+  static constexpr int CELLS = CHUNK_SIZE * CHUNK_SIZE;
+  static constexpr int RIM = 2; // neighbour cells the move rules read
+  static constexpr int SNAP = CHUNK_SIZE + 2 * RIM;
+
+  struct Portal {
+    Coord pos;
+    std::vector<Coord> exits; // cells in other chunks, one move away
+  };
+
+  struct ChunkPortals {
+    std::array<uint64_t, 9> versions{}; // 3x3 around the chunk, 0 = absent
+    uint64_t checked = 0;               // last search that validated it
+    std::vector<uint8_t> air;           // SNAP x SNAP snapshot, rim included
+    std::vector<Portal> portals;
+    std::vector<uint16_t> cost;         // [i * n + j]: moves from i to j
+  };
+
+  struct Visit {
+    uint32_t g;
+    Coord parent;
+  };
+
+  struct Open {
+    uint32_t f, g;
+    Coord pos;
+    bool operator<(const Open &o) const { return f > o.f; } // min-heap
+  };
+
+  RobinHoodMap<Coord, ChunkPortals, CoordHash> chunks_;
+  RobinHoodMap<Coord, Visit, CoordHash> visits_;
+  std::vector<Open> open_;
+  std::vector<uint16_t> to_goal_; // per portal of the goal's chunk
+  std::vector<Coord> waypoints_;
+  uint64_t search_ = 0;
+  size_t rebuilds_ = 0;
+
+  // In-chunk BFS scratch
+  std::array<uint16_t, CELLS> dist_;
+  std::array<uint8_t, CELLS> from_;
+  std::vector<uint16_t> queue_;
+
+  static Coord origin_of(Coord cp) {
+    return {cp.x * CHUNK_SIZE, cp.y * CHUNK_SIZE};
+  }
+
+  static int local_index(Coord w, Coord base) {
+    return (w.y - base.y) * CHUNK_SIZE + (w.x - base.x);
+  }
+
+  static bool inside(Coord w, Coord base) {
+    return static_cast<unsigned>(w.x - base.x) < CHUNK_SIZE &&
+           static_cast<unsigned>(w.y - base.y) < CHUNK_SIZE;
+  }
+
+  static std::array<uint64_t, 9> versions_around(const World &world,
+                                                 Coord cp) {
+    std::array<uint64_t, 9> v{};
+    for (int i = 0; i < 9; ++i) {
+      const Chunk *c = world.peek_chunk({cp.x + i % 3 - 1, cp.y + i / 3 - 1});
+      if (c)
+        v[i] = c->solidity_version();
+    }
+    return v;
+  }
+
+  // May a search enter cp: resident, or shared sky beside a resident chunk
+  static bool in_graph(const World &world, Coord cp) {
+    const Chunk *c = world.peek_chunk(cp);
+    if (!c || !c->is_shared())
+      return c != nullptr;
+    if (!c->is_air(0, 0))
+      return false;
+    for (int i = 0; i < 9; ++i) {
+      const Chunk *n = world.peek_chunk({cp.x + i % 3 - 1, cp.y + i / 3 - 1});
+      if (n && !n->is_shared())
+        return true;
+    }
+    return false;
+  }
+
+  // Is the chunk of w, a cell in or next to the chunk at base, loaded
+  static bool loaded(const std::array<uint64_t, 9> &v, Coord base, Coord w) {
+    int ox = w.x < base.x ? 0 : w.x >= base.x + CHUNK_SIZE ? 2 : 1;
+    int oy = w.y < base.y ? 0 : w.y >= base.y + CHUNK_SIZE ? 2 : 1;
+    return v[oy * 3 + ox] != 0;
+  }
+
+  static auto snapshot(const ChunkPortals &e, Coord base) {
+    return [&e, base](int wx, int wy) {
+      return e.air[static_cast<size_t>(wy - base.y + RIM) * SNAP +
+                   (wx - base.x + RIM)] != 0;
+    };
+  }
+
+  // BFS inside the chunk from local cell start, filling dist_ and from_.
+  // Forward: dist_ is moves from start, from_ the move into each cell.
+  // Reverse: dist_ is moves to start, from_ the first move out of each
+  // cell. Stops early once stop (a local cell) is settled.
+  void local_bfs(const ChunkPortals &e, Coord base, int start, bool reverse,
+                 int stop = -1) {
+    auto snap = snapshot(e, base);
+    dist_.fill(UNREACHED);
+    queue_.clear();
+    dist_[start] = 0;
+    queue_.push_back(static_cast<uint16_t>(start));
+    for (size_t head = 0; head < queue_.size(); ++head) {
+      int v = queue_[head];
+      if (v == stop)
+        return;
+      Coord vp = {base.x + v % CHUNK_SIZE, base.y + v / CHUNK_SIZE};
+      for (uint8_t m = 0; m < 8; ++m) {
+        Coord np = reverse ? vp - PATH_DIRS[m] : vp + PATH_DIRS[m];
+        if (!inside(np, base))
+          continue;
+        int n = local_index(np, base);
+        if (dist_[n] != UNREACHED)
+          continue;
+        if (reverse ? !can_step(np, PATH_DIRS[m], snap)
+                    : !can_step(vp, PATH_DIRS[m], snap))
+          continue;
+        dist_[n] = static_cast<uint16_t>(dist_[v] + 1);
+        from_[n] = m;
+        queue_.push_back(static_cast<uint16_t>(n));
+      }
+    }
+  }
+
+  void build(ChunkPortals &e, Coord cp, const std::array<uint64_t, 9> &v,
+             World::Cursor &cursor) {
+    ++rebuilds_;
+    e.versions = v;
+    Coord base = origin_of(cp);
+    e.air.resize(SNAP * SNAP);
+    for (int y = 0; y < SNAP; ++y) {
+      for (int x = 0; x < SNAP; ++x) {
+        e.air[static_cast<size_t>(y) * SNAP + x] =
+            cursor.try_is_air(base.x + x - RIM, base.y + y - RIM) == true;
+      }
+    }
+    auto snap = snapshot(e, base);
+
+    // A border air cell is a portal if a move leaves from it or lands on
+    // it across the border
+    e.portals.clear();
+    for (int y = 0; y < CHUNK_SIZE; ++y) {
+      int step = (y == 0 || y == CHUNK_SIZE - 1) ? 1 : CHUNK_SIZE - 1;
+      for (int x = 0; x < CHUNK_SIZE; x += step) {
+        Coord u = {base.x + x, base.y + y};
+        if (!snap(u.x, u.y))
+          continue;
+        Portal p{u, {}};
+        bool entered = false;
+        for (const Coord &d : PATH_DIRS) {
+          Coord w = u + d;
+          if (inside(w, base) || !loaded(v, base, w))
+            continue;
+          if (can_step(u, d, snap))
+            p.exits.push_back(w);
+          if (can_step(w, u - w, snap))
+            entered = true;
+        }
+        if (entered || !p.exits.empty())
+          e.portals.push_back(std::move(p));
+      }
+    }
+
+    size_t n = e.portals.size();
+    e.cost.assign(n * n, UNREACHED);
+    for (size_t i = 0; i < n; ++i) {
+      local_bfs(e, base, local_index(e.portals[i].pos, base), false);
+      for (size_t j = 0; j < n; ++j)
+        e.cost[i * n + j] = dist_[local_index(e.portals[j].pos, base)];
+    }
+  }
+
+  // Entry for chunk cp, rebuilt if it or a neighbour changed; nullptr if
+  // searches may not enter cp
+  ChunkPortals *fetch(World &world, World::Cursor &cursor, Coord cp) {
+    auto it = chunks_.find(cp);
+    if (it != chunks_.end() && (*it).second.checked == search_)
+      return &(*it).second;
+    if (!in_graph(world, cp)) {
+      if (it != chunks_.end())
+        chunks_.erase(cp);
+      return nullptr;
+    }
+    std::array<uint64_t, 9> v = versions_around(world, cp);
+    ChunkPortals &e = (*chunks_.try_emplace(cp).first).second;
+    if (e.air.empty() || e.versions != v)
+      build(e, cp, v, cursor);
+    e.checked = search_;
+    return &e;
+  }
+
+  static int portal_index(const ChunkPortals &e, Coord pos) {
+    for (size_t i = 0; i < e.portals.size(); ++i) {
+      if (e.portals[i].pos == pos)
+        return static_cast<int>(i);
+    }
+    return -1;
+  }
+
+  void relax(Coord pos, uint32_t g, Coord parent, Coord goal) {
+    auto [it, inserted] = visits_.try_emplace(pos, Visit{g, parent});
+    if (!inserted) {
+      Visit &seen = (*it).second;
+      if (seen.g <= g)
+        return;
+      seen = {g, parent};
+    }
+    uint32_t h = static_cast<uint32_t>(
+        std::max(std::abs(goal.x - pos.x), std::abs(goal.y - pos.y)));
+    open_.push_back({g + h, g, pos});
+    std::push_heap(open_.begin(), open_.end());
+  }
+
+  // Append the cells after a up to and including b: one move if they are
+  // in different chunks, otherwise a BFS inside their chunk
+  void refine(ChunkPortals &e, Coord a, Coord b, std::vector<Coord> &path) {
+    Coord base = origin_of(World::world_to_chunk(a.x, a.y));
+    if (!inside(b, base)) {
+      path.push_back(b);
+      return;
+    }
+    int stop = local_index(b, base);
+    local_bfs(e, base, local_index(a, base), false, stop);
+    size_t end = path.size() + dist_[stop];
+    path.resize(end);
+    for (Coord cur = b; cur != a;) {
+      path[--end] = cur;
+      cur = cur - PATH_DIRS[from_[local_index(cur, base)]];
+    }
+  }
+
+public:
+  // Shortest path from s to tar through the graph's chunks into path (s..tar);
+  // false (path empty) if there is none. expanded (if given) receives the
+  // number of abstract nodes popped.
+  bool find_path(World &world, Coord s, Coord tar, std::vector<Coord> &path,
+                 size_t *expanded = nullptr) {
+    path.clear();
+    if (expanded)
+      *expanded = 0;
+    if (s == tar) {
+      path.push_back(s);
+      return true;
+    }
+    ++search_;
+    World::Cursor cursor(world);
+    Coord cs = World::world_to_chunk(s.x, s.y);
+    Coord ct = World::world_to_chunk(tar.x, tar.y);
+    // Moves from each portal of the goal's chunk to the goal, inside it.
+    // Entry pointers last only until the next fetch of a new chunk.
+    ChunkPortals *goal = fetch(world, cursor, ct);
+    if (!goal)
+      return false;
+    Coord gbase = origin_of(ct);
+    local_bfs(*goal, gbase, local_index(tar, gbase), true);
+    to_goal_.clear();
+    for (const Portal &p : goal->portals)
+      to_goal_.push_back(dist_[local_index(p.pos, gbase)]);
+
+    // s is not a node: link it to its chunk's portals (and the goal, if
+    // it is in the same chunk) through a BFS, and to any cell it can move
+    // to across the border directly
+    ChunkPortals *start = fetch(world, cursor, cs);
+    if (!start)
+      return false;
+    visits_.clear();
+    open_.clear();
+    visits_.try_emplace(s, Visit{0, s});
+    Coord sbase = origin_of(cs);
+    local_bfs(*start, sbase, local_index(s, sbase), false);
+    for (const Portal &p : start->portals) {
+      uint16_t d = dist_[local_index(p.pos, sbase)];
+      if (d != UNREACHED)
+        relax(p.pos, d, s, tar);
+    }
+    if (cs == ct && dist_[local_index(tar, sbase)] != UNREACHED)
+      relax(tar, dist_[local_index(tar, sbase)], s, tar);
+    auto snap = snapshot(*start, sbase);
+    for (const Coord &d : PATH_DIRS) {
+      Coord w = s + d;
+      if (!inside(w, sbase) && can_step(s, d, snap) &&
+          loaded(start->versions, sbase, w))
+        relax(w, 1, s, tar);
+    }
+
+    size_t popped = 0;
+    bool found = false;
+    while (!open_.empty()) {
+      std::pop_heap(open_.begin(), open_.end());
+      Open cur = open_.back();
+      open_.pop_back();
+      if ((*visits_.find(cur.pos)).second.g < cur.g)
+        continue; // superseded
+      ++popped;
+      if (cur.pos == tar) {
+        found = true;
+        break;
+      }
+      Coord cp = World::world_to_chunk(cur.pos.x, cur.pos.y);
+      ChunkPortals *e = fetch(world, cursor, cp);
+      int i = e ? portal_index(*e, cur.pos) : -1;
+      if (i < 0)
+        continue;
+      size_t n = e->portals.size();
+      for (size_t j = 0; j < n; ++j) {
+        uint16_t c = e->cost[i * n + j];
+        if (c != UNREACHED && static_cast<int>(j) != i)
+          relax(e->portals[j].pos, cur.g + c, cur.pos, tar);
+      }
+      for (const Coord &w : e->portals[i].exits)
+        relax(w, cur.g + 1, cur.pos, tar);
+      if (cp == ct && to_goal_[i] != UNREACHED)
+        relax(tar, cur.g + to_goal_[i], cur.pos, tar);
+    }
+    if (expanded)
+      *expanded = popped;
+    if (!found)
+      return false;
+
+    waypoints_.clear();
+    for (Coord c = tar; c != s; c = (*visits_.find(c)).second.parent)
+      waypoints_.push_back(c);
+    waypoints_.push_back(s);
+    std::reverse(waypoints_.begin(), waypoints_.end());
+
+    path.push_back(s);
+    for (size_t k = 1; k < waypoints_.size(); ++k) {
+      Coord a = waypoints_[k - 1];
+      ChunkPortals *e =
+          fetch(world, cursor, World::world_to_chunk(a.x, a.y));
+      refine(*e, a, waypoints_[k], path);
+    }
+    return true;
+  }
+
+  // Chunks with a portal table, and their portals in total
+  size_t chunk_count() const { return chunks_.size(); }
+  size_t portal_count() const {
+    size_t n = 0;
+    for (auto [pos, e] : chunks_)
+      n += e.portals.size();
+    return n;
+  }
+  size_t rebuild_count() const { return rebuilds_; }
+
+  void clear() { chunks_.clear(); }
+};
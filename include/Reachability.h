@@ -0,0 +1,444 @@
+#pragma once
+#include "Chunk.h"
+#include "Coord.h"
+#include "RobinHoodMap.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+// ============================================================================
+//  ReachabilityIndex — Connected Components of Air over Resident Chunks
+// ============================================================================
+//
+//  Answers "could a mob at A ever reach B?" before any search runs. Every
+//  move a search makes lands on an air cell 8-adjacent to the last one, so
+//  two air cells in different 8-connected components of air can never be
+//  joined by a path, whatever the walk/climb/fall rules allow. The
+//  components are kept in two levels:
+//
+//  1. per chunk — a flood fill labels each air cell of a resident chunk
+//                 with a component number (0 = solid). Redone only for a
+//                 chunk marked stale: newly installed, or set_block turned
+//                 one of its cells from air to solid or back.
+//  2. links     — for each chunk, the distinct (own label, direction,
+//                 neighbour label) triples where its border air touches
+//                 air across a border or corner. Unstored uniform sky is
+//                 one component, SKY; chunks that aren't loaded and
+//                 bedrock are solid, as they are to bfs_findpath.
+//                 Recomputed only for a chunk that was relabelled,
+//                 installed or removed, and for its eight neighbours.
+//  3. joins     — a union-find over every chunk's components, fed by the
+//                 links.
+//
+//  Union-find can join but not split, so changes are handled by what they
+//  can do to connectivity:
+//
+//  - Changes that can only join (a new chunk where there was no sky, a
+//    cell turned to air) are applied on the next query by giving the
+//    relabelled chunks fresh nodes and uniting their new links.
+//    Superseded nodes stay behind, still joined to what they touched,
+//    which is harmless because a cell that became air joins no less
+//    than before.
+//  - A cell inside a chunk (off its border) turned solid leaves every
+//    crossing in place, so it can only split the chunk's own components.
+//    The relabel checks for that: if every old component still maps to a
+//    single new one, the change is applied as a joining one.
+//  - Changes that can split (a border cell turned solid, a component
+//    split, a chunk dropped or replaced, a chunk stored where sky used to
+//    link) renumber every component and re-run the union-find from the
+//    stored links. No chunk is relabelled and no border is rescanned
+//    unless it changed.
+//
+//  Superseded nodes are also reclaimed by the next renumbering, which
+//  happens early when they outnumber the live ones.
+//
+//  A query is then a few label reads and two finds. The answer is
+//  one-sided: false means no search can succeed, true only that one may
+//  (connectivity doesn't know a bare wall can't be climbed).
+//
+//  The World owns one and keeps it current; it does nothing until the
+//  first query, so worlds that never ask pay one branch per chunk install.
+//
+// ============================================================================
+
+class ReachabilityIndex {
+public:
+  static constexpr uint32_t SKY = 0;          // node of all unstored sky
+  static constexpr uint32_t NONE = UINT32_MAX; // solid or not loaded
+
+private:
+  static constexpr int CELLS = CHUNK_SIZE * CHUNK_SIZE;
+
+  // Border air of one chunk touching air of the neighbour in direction
+  // dir ((oy + 1) * 3 + ox + 1); other = 0 means that neighbour is sky
+  struct Link {
+    uint8_t dir;
+    uint16_t label;
+    uint16_t other;
+    auto operator<=>(const Link &) const = default;
+  };
+
+  struct Components {
+    const Chunk *chunk = nullptr;
+    std::vector<uint16_t> label; // per cell, 0 = solid; empty until labelled
+    std::vector<Link> links;     // sorted, distinct
+    uint32_t base = 0;           // node of label l is base + l
+    uint16_t count = 0;
+    bool stale = true;   // labels don't match the chunk
+    bool filled = false; // an inner cell turned solid since the last relabel
+    bool queued = false; // in pending_: links to recompute
+  };
+
+  bool active_ = false;
+  bool renumber_ = true; // union-find must be redone from all links
+  RobinHoodMap<Coord, Components, CoordHash> chunks_;
+  std::vector<Coord> pending_; // chunks whose links went stale, once each
+  std::vector<Components *> relabelled_; // by this update
+  std::vector<uint32_t> parent_;
+  std::vector<uint16_t> stack_; // flood fill scratch
+  std::vector<uint16_t> old_label_, label_map_; // split check scratch
+  size_t live_nodes_ = 0;       // sum of count over chunks_
+  size_t relabels_ = 0;
+  size_t rebuilds_ = 0;
+  size_t increments_ = 0;
+  static int floor_div(int v) {
+    return v >= 0 ? v / CHUNK_SIZE : (v - CHUNK_SIZE + 1) / CHUNK_SIZE;
+  }
+
+  uint32_t find(uint32_t v) {
+    while (parent_[v] != v) {
+      parent_[v] = parent_[parent_[v]]; // path halving
+      v = parent_[v];
+    }
+    return v;
+  }
+
+  void unite(uint32_t a, uint32_t b) {
+    a = find(a);
+    b = find(b);
+    if (a == b)
+      return;
+    // The smaller root wins, so SKY stays the root of anything it joins
+    if (a < b)
+      parent_[b] = a;
+    else
+      parent_[a] = b;
+  }
+
+  // Flood fill c's labels. True if a filled cell split one of its old
+  // components in two.
+  bool relabel(Components &c) {
+    bool check = c.filled && !c.label.empty();
+    if (check)
+      old_label_.swap(c.label);
+    c.label.assign(CELLS, 0);
+    uint16_t n = 0;
+    for (int i = 0; i < CELLS; ++i) {
+      if (c.label[i] || !c.chunk->is_air(i % CHUNK_SIZE, i / CHUNK_SIZE))
+        continue;
+      c.label[i] = ++n;
+      stack_.push_back(static_cast<uint16_t>(i));
+      while (!stack_.empty()) {
+        int v = stack_.back();
+        stack_.pop_back();
+        int vx = v % CHUNK_SIZE, vy = v / CHUNK_SIZE;
+        for (int y = vy - 1; y <= vy + 1; ++y) {
+          for (int x = vx - 1; x <= vx + 1; ++x) {
+            if (x < 0 || x >= CHUNK_SIZE || y < 0 || y >= CHUNK_SIZE)
+              continue;
+            int u = y * CHUNK_SIZE + x;
+            if (c.label[u] || !c.chunk->is_air(x, y))
+              continue;
+            c.label[u] = n;
+            stack_.push_back(static_cast<uint16_t>(u));
+          }
+        }
+      }
+    }
+    bool split = false;
+    if (check) {
+      label_map_.assign(static_cast<size_t>(c.count) + 1, 0);
+      for (int i = 0; i < CELLS && !split; ++i) {
+        uint16_t was = old_label_[i], now = c.label[i];
+        if (!was || !now)
+          continue;
+        if (!label_map_[was])
+          label_map_[was] = now;
+        split = label_map_[was] != now;
+      }
+    }
+    live_nodes_ = live_nodes_ - c.count + n;
+    c.count = n;
+    c.stale = false;
+    c.filled = false;
+    ++relabels_;
+    return split;
+  }
+
+  static constexpr Coord neighbour(Coord pos, int dir) {
+    return {pos.x + dir % 3 - 1, pos.y + dir / 3 - 1};
+  }
+
+  // Recompute c's links. Border cells only: every move out of the chunk
+  // starts on one.
+  template <typename IsSky>
+  void relink(Coord pos, Components &c, IsSky &&is_sky) {
+    // The eight surrounding chunks: indexed, sky, or neither
+    const Components *around[9] = {};
+    bool sky[9] = {};
+    for (int dir = 0; dir < 9; ++dir) {
+      if (dir == 4)
+        continue;
+      Coord np = neighbour(pos, dir);
+      auto it = chunks_.find(np);
+      if (it != chunks_.end())
+        around[dir] = &(*it).second;
+      else
+        sky[dir] = is_sky(np);
+    }
+
+    c.links.clear();
+    for (int y = 0; y < CHUNK_SIZE; ++y) {
+      int step = (y == 0 || y == CHUNK_SIZE - 1) ? 1 : CHUNK_SIZE - 1;
+      for (int x = 0; x < CHUNK_SIZE; x += step) {
+        uint16_t l = c.label[y * CHUNK_SIZE + x];
+        if (!l)
+          continue;
+        for (int ny = y - 1; ny <= y + 1; ++ny) {
+          for (int nx = x - 1; nx <= x + 1; ++nx) {
+            int ox = nx < 0 ? -1 : nx >= CHUNK_SIZE ? 1 : 0;
+            int oy = ny < 0 ? -1 : ny >= CHUNK_SIZE ? 1 : 0;
+            int dir = (oy + 1) * 3 + ox + 1;
+            if (dir == 4)
+              continue;
+            if (sky[dir]) {
+              c.links.push_back({static_cast<uint8_t>(dir), l, 0});
+            } else if (const Components *o = around[dir]) {
+              int lx = nx - ox * CHUNK_SIZE, ly = ny - oy * CHUNK_SIZE;
+              if (uint16_t ol = o->label[ly * CHUNK_SIZE + lx])
+                c.links.push_back({static_cast<uint8_t>(dir), l, ol});
+            }
+          }
+        }
+      }
+    }
+    std::sort(c.links.begin(), c.links.end());
+    c.links.erase(std::unique(c.links.begin(), c.links.end()), c.links.end());
+    c.queued = false;
+  }
+
+  // Unite c's components with what its links touch. Each crossing is
+  // linked from both sides; unite() doesn't mind.
+  void join(Coord pos, const Components &c) {
+    const Components *o = nullptr;
+    int dir = -1;
+    for (const Link &k : c.links) {
+      if (k.other == 0) {
+        unite(c.base + k.label, SKY);
+        continue;
+      }
+      if (k.dir != dir) {
+        dir = k.dir;
+        auto it = chunks_.find(neighbour(pos, dir));
+        o = it != chunks_.end() ? &(*it).second : nullptr;
+      }
+      if (o)
+        unite(c.base + k.label, o->base + k.other);
+    }
+  }
+
+  // Fresh nodes for a relabelled chunk; its old ones are left behind
+  void allocate(Components &c) {
+    c.base = static_cast<uint32_t>(parent_.size()) - 1;
+    size_t first = parent_.size();
+    parent_.resize(first + c.count);
+    std::iota(parent_.begin() + first, parent_.end(),
+              static_cast<uint32_t>(first));
+  }
+
+  // Queue pos and its eight neighbours for new links
+  void touch_around(Coord pos) {
+    for (int dir = 0; dir < 9; ++dir) {
+      Coord np = neighbour(pos, dir);
+      auto it = chunks_.find(np);
+      if (it == chunks_.end() || (*it).second.queued)
+        continue;
+      (*it).second.queued = true;
+      pending_.push_back(np);
+    }
+  }
+
+  // Bring labels, links and the union-find up to date with every change
+  // since the last query
+  template <typename IsSky> void update(IsSky &&is_sky) {
+    if (pending_.empty() && !renumber_)
+      return;
+    // Superseded nodes left by joining changes are reclaimed once they
+    // outnumber the live ones
+    bool renumber = renumber_ || parent_.size() > 2 * live_nodes_ + CELLS;
+
+    // Chunks removed since they were queued are dropped from the queue
+    std::erase_if(pending_, [this](Coord pos) {
+      return chunks_.find(pos) == chunks_.end();
+    });
+    relabelled_.clear();
+    for (Coord pos : pending_) {
+      Components &c = (*chunks_.find(pos)).second;
+      if (c.stale) {
+        renumber |= relabel(c);
+        relabelled_.push_back(&c);
+      }
+    }
+    if (!renumber) {
+      for (Components *c : relabelled_)
+        allocate(*c);
+    }
+    for (Coord pos : pending_)
+      relink(pos, (*chunks_.find(pos)).second, is_sky);
+
+    if (renumber) {
+      uint32_t next = SKY + 1;
+      for (auto [pos, c] : chunks_) {
+        c.base = next - 1;
+        next += c.count;
+      }
+      parent_.resize(next);
+      std::iota(parent_.begin(), parent_.end(), 0u);
+      for (auto [pos, c] : chunks_)
+        join(pos, c);
+      renumber_ = false;
+      ++rebuilds_;
+    } else {
+      for (Coord pos : pending_)
+        join(pos, (*chunks_.find(pos)).second);
+      ++increments_;
+    }
+    pending_.clear();
+  }
+
+  template <typename IsSky> uint32_t node_of(Coord w, IsSky &&is_sky) {
+    Coord cp = {floor_div(w.x), floor_div(w.y)};
+    auto it = chunks_.find(cp);
+    if (it == chunks_.end())
+      return is_sky(cp) ? SKY : NONE;
+    const Components &c = (*it).second;
+    int lx = w.x - cp.x * CHUNK_SIZE, ly = w.y - cp.y * CHUNK_SIZE;
+    uint16_t l = c.label[ly * CHUNK_SIZE + lx];
+    return l ? c.base + l : NONE;
+  }
+
+public:
+  bool active() const { return active_; }
+
+  // Start tracking; the owner then reports every resident chunk
+  void activate() {
+    active_ = true;
+    renumber_ = true;
+  }
+
+  // ---------------------------------------------------------------
+  //  Updates from the owning World (no-ops until activate())
+  // ---------------------------------------------------------------
+
+  // Chunk now resident at pos (new, faulted in, or replacing another)
+  void installed(Coord pos, const Chunk *chunk) {
+    if (!active_)
+      return;
+    auto [it, inserted] = chunks_.try_emplace(pos);
+    Components &c = (*it).second;
+    c.chunk = chunk;
+    c.stale = true;
+    if (!inserted) {
+      renumber_ = true; // the new contents may join less
+    } else {
+      // Where pos was sky, neighbours were joined through it
+      for (int dir = 0; dir < 9 && !renumber_; ++dir) {
+        auto nit = chunks_.find(neighbour(pos, 8 - dir));
+        if (dir == 4 || nit == chunks_.end())
+          continue;
+        for (const Link &k : (*nit).second.links) {
+          if (k.dir == dir && k.other == 0)
+            renumber_ = true;
+        }
+      }
+    }
+    touch_around(pos);
+  }
+
+  void removed(Coord pos) {
+    if (!active_)
+      return;
+    auto it = chunks_.find(pos);
+    if (it == chunks_.end())
+      return;
+    live_nodes_ -= (*it).second.count;
+    chunks_.erase(pos);
+    renumber_ = true;
+    touch_around(pos);
+  }
+
+  // Cell (lx, ly) of the chunk at pos changed between air and solid;
+  // now_air says which way
+  void changed(Coord pos, int lx, int ly, bool now_air) {
+    if (!active_)
+      return;
+    auto it = chunks_.find(pos);
+    if (it == chunks_.end())
+      return;
+    Components &c = (*it).second;
+    c.stale = true;
+    if (!now_air) {
+      bool border = lx == 0 || ly == 0 || lx == CHUNK_SIZE - 1 ||
+                    ly == CHUNK_SIZE - 1;
+      if (border)
+        renumber_ = true; // a crossing may be gone
+      else
+        c.filled = true;
+    }
+    touch_around(pos);
+  }
+
+  void clear() {
+    chunks_.clear();
+    pending_.clear();
+    parent_.clear();
+    live_nodes_ = 0;
+    renumber_ = true;
+  }
+
+  // ---------------------------------------------------------------
+  //  Query. is_sky(chunk) says whether an unindexed chunk is unstored
+  //  uniform air (the rest count as solid).
+  // ---------------------------------------------------------------
+
+  // false only if no sequence of moves between air cells gets from a to b.
+  // b must be air; a may be inside a block, as long as some cell next to
+  // it connects to b.
+  template <typename IsSky> bool may_reach(Coord a, Coord b, IsSky &&is_sky) {
+    if (a == b)
+      return true;
+    update(is_sky);
+    uint32_t nb = node_of(b, is_sky);
+    if (nb == NONE)
+      return false;
+    nb = find(nb);
+    if (uint32_t na = node_of(a, is_sky); na != NONE)
+      return find(na) == nb;
+    for (int y = a.y - 1; y <= a.y + 1; ++y) {
+      for (int x = a.x - 1; x <= a.x + 1; ++x) {
+        uint32_t n = node_of({x, y}, is_sky);
+        if (n != NONE && find(n) == nb)
+          return true;
+      }
+    }
+    return false;
+  }
+
+  size_t chunk_count() const { return chunks_.size(); }
+  size_t component_count() const { return live_nodes_ + 1; } // incl. SKY
+  size_t relabel_count() const { return relabels_; }
+  size_t rebuild_count() const { return rebuilds_; }     // renumberings
+  size_t increment_count() const { return increments_; } // joins only
+};
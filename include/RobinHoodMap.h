@@ -1,10 +1,30 @@
 #pragma once
+#include <algorithm>
+#include <bit>
 #include <cassert>
 #include <cstdint>
 #include <cstring>
 #include <functional>
 #include <new>
+#include <span>
+#include <stdexcept>
 #include <utility>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ROBINHOOD_SSE2 1
+#endif
+
+// Build with -DROBINHOOD_STATS to have every map count its probes, grows
+// and erase shifts (RobinHoodStats). Without it the counters and the code
+// that bumps them don't exist.
+#ifdef ROBINHOOD_STATS
+#define ROBINHOOD_STAT(...) __VA_ARGS__
+#else
+#define ROBINHOOD_STAT(...)
+#endif
 
 // ============================================================================
 //  RobinHoodMap — Cache-Friendly Robin Hood Hash Map
@@ -18,51 +38,267 @@
 //     way to elements further from home, keeping probe lengths balanced
 //  3. Power-of-2 capacity — bitmask instead of expensive modulo division
 //  4. Backward-shift deletion — no tombstones, maintains Robin Hood order
-//  5. Golden-ratio hash mixing — combines with your existing CoordHash
+//  5. Control bytes apart from the slots, Swiss-table style — one byte per
+//     slot holding its probe distance, matched 16 at a time with SSE2. A
+//     slot's key is compared only when its byte says it shares our home;
+//     values are never read while probing.
+//  6. The low bits of the hash pick the home slot, so every hash goes
+//     through the fmix64 finalizer first (std::hash is the identity on
+//     integers with libstdc++). A Hash that already mixes its output
+//     says so with `using is_avalanching = void;` and is used as is;
+//     CoordHash does.
 //
 // ============================================================================
 
+// murmur3's fmix64: every input bit flips about half the output bits
+inline uint64_t robinhood_mix(uint64_t k) {
+  k ^= k >> 33;
+  k *= 0xff51afd7ed558ccdULL;
+  k ^= k >> 33;
+  k *= 0xc4ceb9fe1a85ec53ULL;
+  k ^= k >> 33;
+  return k;
+}
+
+// Hash output fit for taking the low bits of
+template <typename Hash, typename K>
+inline size_t robinhood_hash(const Hash &hasher, const K &key) {
+  if constexpr (requires { typename Hash::is_avalanching; })
+    return hasher(key);
+  else
+    return static_cast<size_t>(robinhood_mix(hasher(key)));
+}
+
+// ---------------------------------------------------------------------------
+//  Slot layouts — where RobinHoodMap keeps keys and values. Control bytes
+//  always have their own array; the layout only decides whether a key and
+//  its value share a cache line.
+//
+//  RobinHoodAoS: one array of {key, value} (default). A hit finds its value
+//                on the line it just compared the key on.
+//  RobinHoodSoA: parallel key and value arrays, as in MobStorage. Probes
+//                pull in keys only, and iterating values walks one array.
+//
+//  Storage is a bare handle: the map constructs, moves and destroys the
+//  elements and calls release() once they are gone.
+// ---------------------------------------------------------------------------
+struct RobinHoodAoS {
+  template <typename K, typename V> class Storage {
+    struct Slot {
+      K key;
+      V value;
+    };
+    Slot *slots_ = nullptr;
+
+  public:
+    void allocate(size_t cap) {
+      slots_ = static_cast<Slot *>(::operator new(sizeof(Slot) * cap));
+    }
+    void release() {
+      ::operator delete(slots_);
+      slots_ = nullptr;
+    }
+    bool allocated() const { return slots_ != nullptr; }
+
+    K &key(size_t i) const { return slots_[i].key; }
+    V &value(size_t i) const { return slots_[i].value; }
+  };
+};
+
+struct RobinHoodSoA {
+  template <typename K, typename V> class Storage {
+    K *keys_ = nullptr;
+    V *values_ = nullptr;
+
+  public:
+    void allocate(size_t cap) {
+      keys_ = static_cast<K *>(::operator new(sizeof(K) * cap));
+      values_ = static_cast<V *>(::operator new(sizeof(V) * cap));
+    }
+    void release() {
+      ::operator delete(keys_);
+      ::operator delete(values_);
+      keys_ = nullptr;
+      values_ = nullptr;
+    }
+    bool allocated() const { return keys_ != nullptr; }
+
+    K &key(size_t i) const { return keys_[i]; }
+    V &value(size_t i) const { return values_[i]; }
+  };
+};
+
+// What a map built with ROBINHOOD_STATS has counted since construction or
+// reset_stats(); all zero otherwise. A probe is one walk of a table —
+// lookups, erases and insert planning alike; a hit at its home slot walks
+// 1 slot. The counters aren't atomic: several threads reading one map at
+// once would race on them.
+struct RobinHoodStats {
+#ifdef ROBINHOOD_STATS
+  static constexpr bool enabled = true;
+#else
+  static constexpr bool enabled = false;
+#endif
+
+  uint64_t probes = 0;
+  uint64_t probe_slots = 0;     // slots walked, over all probes
+  uint64_t max_probe = 0;       // longest single walk, in slots
+  uint64_t key_compares = 0;
+  uint64_t grows = 0;           // load-triggered (rebuild or migration start)
+  uint64_t erases = 0;          // entries removed by erase()
+  uint64_t erase_shifts = 0;    // entries pulled back one slot by those
+  uint64_t max_erase_shift = 0;
+
+  double avg_probe() const {
+    return probes ? static_cast<double>(probe_slots) / probes : 0.0;
+  }
+  double avg_erase_shift() const {
+    return erases ? static_cast<double>(erase_shifts) / erases : 0.0;
+  }
+};
+
 template <typename K, typename V, typename Hash = std::hash<K>,
-          typename KeyEqual = std::equal_to<K>>
+          typename KeyEqual = std::equal_to<K>,
+          typename Layout = RobinHoodAoS>
 class RobinHoodMap {
 public:
   using key_type = K;
   using mapped_type = V;
 
 private:
-  // Each slot stores the key, value, and cached hash.
-  // 'occupied' tracks whether the slot is in use.
-  struct Slot {
-    K key;
-    V value;
-    size_t hash;     // cached hash (avoids rehashing during probe/eviction)
-    bool occupied;
+  using Store = typename Layout::template Storage<K, V>;
+
+  // ---------------------------------------------------------------
+  //  Control bytes — one per slot: distance from home + 1, 0 = empty.
+  //  A probe starting at home h expects slot h+i to hold i+1 if the
+  //  occupant shares its home, and stops at the first byte below that
+  //  (empty, or an entry that would have been evicted by ours).
+  // ---------------------------------------------------------------
+  static constexpr size_t GROUP = 16;
+
+  struct Group {
+#ifdef ROBINHOOD_SSE2
+    __m128i ctrl;
+
+    explicit Group(const uint8_t *p)
+        : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p))) {}
+
+    static __m128i expected(unsigned first) {
+      return _mm_add_epi8(_mm_set1_epi8(static_cast<char>(first)),
+                          _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11,
+                                        12, 13, 14, 15));
+    }
+
+    // Bit i: slot i holds an entry from our home (byte == first + i)
+    uint32_t match_home(unsigned first) const {
+      return static_cast<uint32_t>(
+          _mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, expected(first))));
+    }
+
+    // Bit i: slot i ends the probe (byte < first + i, unsigned)
+    uint32_t match_stop(unsigned first) const {
+      __m128i exp = expected(first);
+      __m128i ge = _mm_cmpeq_epi8(_mm_max_epu8(ctrl, exp), ctrl);
+      return ~static_cast<uint32_t>(_mm_movemask_epi8(ge)) & 0xFFFFu;
+    }
+
+    uint32_t match_byte(uint8_t b) const {
+      return static_cast<uint32_t>(_mm_movemask_epi8(
+          _mm_cmpeq_epi8(ctrl, _mm_set1_epi8(static_cast<char>(b)))));
+    }
+#else
+    uint8_t ctrl[GROUP];
+
+    explicit Group(const uint8_t *p) { std::memcpy(ctrl, p, GROUP); }
+
+    uint32_t match_home(unsigned first) const {
+      uint32_t m = 0;
+      for (unsigned i = 0; i < GROUP; ++i)
+        m |= static_cast<uint32_t>(ctrl[i] == first + i) << i;
+      return m;
+    }
+
+    uint32_t match_stop(unsigned first) const {
+      uint32_t m = 0;
+      for (unsigned i = 0; i < GROUP; ++i)
+        m |= static_cast<uint32_t>(ctrl[i] < first + i) << i;
+      return m;
+    }
+
+    uint32_t match_byte(uint8_t b) const {
+      uint32_t m = 0;
+      for (unsigned i = 0; i < GROUP; ++i)
+        m |= static_cast<uint32_t>(ctrl[i] == b) << i;
+      return m;
+    }
+#endif
+
+    uint32_t match_empty() const { return match_byte(0); }
   };
 
-  Slot *slots_ = nullptr;
-  size_t capacity_ = 0;   // always power of 2
+  Store store_;
+  // capacity_ + GROUP bytes; the tail mirrors the first GROUP bytes so a
+  // group load starting anywhere in the table never has to wrap
+  uint8_t *ctrl_ = nullptr;
+  size_t capacity_ = 0;   // always power of 2, at least GROUP
   size_t mask_ = 0;        // capacity_ - 1, for branchless modulo
-  size_t size_ = 0;
+  size_t size_ = 0;        // entries in both tables
   size_t grow_at_ = 0;     // size threshold to trigger growth
 
+  // Incremental mode: after a grow the previous table stays here and is
+  // drained MIGRATE_STEP slots per insert/erase. Lookups check both.
+  // ctrl == nullptr when nothing is being migrated.
+  struct OldTable {
+    Store store;
+    uint8_t *ctrl = nullptr;
+    size_t capacity = 0;
+    size_t mask = 0;
+    size_t size = 0;    // entries not migrated yet
+    size_t next = 0;    // next slot to drain
+  };
+  OldTable old_;
+  bool incremental_ = false;
+
   Hash hasher_;
   KeyEqual eq_;
 
-  static constexpr size_t MIN_CAPACITY = 8;
-  static constexpr float MAX_LOAD = 0.85f;
-
-  // Home index: where this hash ideally wants to be
-  size_t home_of(size_t h) const { return h & mask_; }
+#ifdef ROBINHOOD_STATS
+  mutable RobinHoodStats stats_;
 
-  // Probe Sequence Length: how far this slot is from its home
-  size_t psl_of(size_t idx, size_t home) const {
-    return (idx + capacity_ - home) & mask_;
+  void note_probe(uint64_t slots) const {
+    ++stats_.probes;
+    stats_.probe_slots += slots;
+    stats_.max_probe = std::max(stats_.max_probe, slots);
   }
-
-  size_t psl_at(size_t idx) const {
-    return psl_of(idx, home_of(slots_[idx].hash));
+#endif
+
+  static constexpr size_t MIN_CAPACITY = GROUP;
+  // Past ~0.75 the hit path's probe count (and its mispredicted loop exit)
+  // climbs fast: 0.76 load measured ~2x the lookup time of 0.5
+  static constexpr float MAX_LOAD = 0.75f;
+  // Probe lengths this long only happen with a broken hash; grow instead.
+  // Kept at 240 so first + 15 in a group compare never wraps a byte.
+  static constexpr unsigned MAX_DIST = 240;
+  // Grows for a too-long run (rather than load) stop at this many slots
+  // per entry: past that the run is keys with equal hashes, which no
+  // capacity separates.
+  static constexpr size_t MAX_WEAK_SPREAD = 64;
+  // Old slots drained per insert/erase. A grow leaves capacity/2 old slots
+  // and 0.75 * capacity/2 inserts before the next grow, so anything >= 2
+  // finishes in time; 16 is one control group.
+  static constexpr size_t MIGRATE_STEP = 16;
+
+  size_t hash_of(const K &key) const { return robinhood_hash(hasher_, key); }
+
+  // Write a control byte and its mirror (for idx < GROUP, the second
+  // store lands on capacity + idx; otherwise it rewrites idx itself)
+  static void write_ctrl(uint8_t *ctrl, size_t mask, size_t idx, unsigned v) {
+    ctrl[idx] = static_cast<uint8_t>(v);
+    ctrl[((idx - GROUP) & mask) + GROUP] = static_cast<uint8_t>(v);
   }
 
+  void set_ctrl(size_t idx, unsigned v) { write_ctrl(ctrl_, mask_, idx, v); }
+
   // ---------------------------------------------------------------
   //  Memory management
   // ---------------------------------------------------------------
@@ -70,210 +306,456 @@ private:
     capacity_ = cap;
     mask_ = cap - 1;
     grow_at_ = static_cast<size_t>(static_cast<float>(cap) * MAX_LOAD);
-    slots_ = static_cast<Slot *>(::operator new(sizeof(Slot) * cap));
+    store_.allocate(cap);
+    ctrl_ = new uint8_t[cap + GROUP]();
+  }
+
+  static void destroy_entries(Store st, const uint8_t *ctrl, size_t cap) {
     for (size_t i = 0; i < cap; ++i) {
-      slots_[i].occupied = false;
+      if (ctrl[i]) {
+        st.key(i).~K();
+        st.value(i).~V();
+      }
     }
   }
 
+  void drop_old() {
+    if (!old_.ctrl) return;
+    destroy_entries(old_.store, old_.ctrl, old_.capacity);
+    old_.store.release();
+    delete[] old_.ctrl;
+    old_ = OldTable{};
+  }
+
   void dealloc() {
-    if (!slots_) return;
-    for (size_t i = 0; i < capacity_; ++i) {
-      if (slots_[i].occupied) {
-        slots_[i].key.~K();
-        slots_[i].value.~V();
-      }
-    }
-    ::operator delete(slots_);
-    slots_ = nullptr;
+    drop_old();
+    if (!store_.allocated()) return;
+    destroy_entries(store_, ctrl_, capacity_);
+    store_.release();
+    delete[] ctrl_;
+    ctrl_ = nullptr;
   }
 
   // ---------------------------------------------------------------
   //  Grow + rehash
   // ---------------------------------------------------------------
   void grow() {
+    ROBINHOOD_STAT(++stats_.grows);
+    finish_migration();
+    size_t cap = capacity_ ? capacity_ * 2 : MIN_CAPACITY;
+    if (incremental_ && size_ > 0)
+      start_migration(cap);
+    else
+      rebuild(cap);
+  }
+
+  // Smallest capacity that holds n entries without growing
+  static size_t capacity_for(size_t n) {
+    size_t cap = MIN_CAPACITY;
+    while (static_cast<size_t>(static_cast<float>(cap) * MAX_LOAD) < n)
+      cap <<= 1;
+    return cap;
+  }
+
+  // Move every entry into a fresh table of new_cap slots, all at once.
+  // Only called with no migration in progress.
+  void rebuild(size_t new_cap) {
     size_t old_cap = capacity_;
-    Slot *old_slots = slots_;
+    Store old = store_;
+    uint8_t *old_ctrl = ctrl_;
 
-    alloc(old_cap * 2);
+    alloc(new_cap);
     size_ = 0;
 
     for (size_t i = 0; i < old_cap; ++i) {
-      if (old_slots[i].occupied) {
-        insert_for_rehash(std::move(old_slots[i].key),
-                          std::move(old_slots[i].value),
-                          old_slots[i].hash);
-        old_slots[i].key.~K();
-        old_slots[i].value.~V();
+      if (old_ctrl[i]) {
+        insert_new(plan_for(old.key(i)), std::move(old.key(i)),
+                   std::move(old.value(i)));
+        old.key(i).~K();
+        old.value(i).~V();
       }
     }
-    ::operator delete(old_slots);
+    old.release();
+    delete[] old_ctrl;
   }
 
-  // Insert during rehash — hash is already known, no duplicate check needed
-  void insert_for_rehash(K &&key, V &&value, size_t h) {
-    size_t idx = home_of(h);
-    size_t psl = 0;
-
-    K ins_key = std::move(key);
-    V ins_val = std::move(value);
-    size_t ins_hash = h;
+  // Incremental grow: the current table becomes old_, an empty one of
+  // new_cap slots takes its place. Costs an allocation and zeroing the
+  // control bytes, not a pass over the entries.
+  void start_migration(size_t new_cap) {
+    old_.store = store_;
+    old_.ctrl = ctrl_;
+    old_.capacity = capacity_;
+    old_.mask = mask_;
+    old_.size = size_;
+    old_.next = 0;
+    alloc(new_cap);
+  }
 
-    while (true) {
-      if (!slots_[idx].occupied) {
-        // Empty slot — place here
-        new (&slots_[idx].key) K(std::move(ins_key));
-        new (&slots_[idx].value) V(std::move(ins_val));
-        slots_[idx].hash = ins_hash;
-        slots_[idx].occupied = true;
-        ++size_;
+  // Drain up to n old slots into the current table. An entry is taken
+  // out with a backward shift, so whatever is left in old_ stays
+  // findable; the slot is only passed once it is empty.
+  void migrate(size_t n) {
+    while (n-- > 0 && old_.ctrl) {
+      if (old_.next == old_.capacity) {
+        assert(old_.size == 0);
+        drop_old();
         return;
       }
-
-      // Robin Hood: evict if current occupant is richer (lower PSL)
-      size_t existing_psl = psl_at(idx);
-      if (existing_psl < psl) {
-        // Swap: we take this spot, displaced element continues
-        std::swap(ins_key, slots_[idx].key);
-        std::swap(ins_val, slots_[idx].value);
-        std::swap(ins_hash, slots_[idx].hash);
-        psl = existing_psl;
+      size_t i = old_.next;
+      if (!old_.ctrl[i]) {
+        ++old_.next;
+        continue;
       }
-
-      idx = (idx + 1) & mask_;
-      ++psl;
+      K key = std::move(old_.store.key(i));
+      V value = std::move(old_.store.value(i));
+      erase_at(old_.store, old_.ctrl, old_.mask, i);
+      --old_.size;
+      --size_;
+      insert_new(plan_for(key), std::move(key), std::move(value));
     }
   }
 
+  void finish_migration() {
+    while (old_.ctrl)
+      migrate(old_.capacity);
+  }
+
   // ---------------------------------------------------------------
-  //  Core insert — returns pointer to value
+  //  Core probe — one walk answers both "where is key" and, on a miss,
+  //  "where would it go"
   // ---------------------------------------------------------------
-  V *do_insert(K &&key, V &&value) {
-    if (size_ >= grow_at_) grow();
+  struct InsertPlan {
+    size_t pos = 0;     // slot the new entry takes
+    size_t gap = 0;     // empty slot ending the run that shifts right
+    unsigned dist = 0;  // the new entry's control byte
+    bool ok = false;    // false: a probe distance would pass MAX_DIST
+  };
 
-    size_t h = hasher_(key);
-    size_t idx = home_of(h);
-    size_t psl = 0;
+  // Slot index of key in the table (st, ctrl, mask), or SIZE_MAX. On a
+  // miss in the current table, plan (if given) says where to insert it.
+  size_t locate_in(Store st, const uint8_t *ctrl, size_t mask, const K &key,
+                   size_t hash, InsertPlan *plan) const {
+    if (!ctrl) return SIZE_MAX;
+
+    size_t idx = hash & mask;
+    for (unsigned first = 1; first <= MAX_DIST; first += GROUP) {
+      Group g(ctrl + idx);
+      uint32_t stop = g.match_stop(first);
+      // Candidates: same-home slots before the first stop (all 16 if none)
+      uint32_t cand = g.match_home(first) & ((stop & (0u - stop)) - 1u);
+      for (; cand; cand &= cand - 1) {
+        size_t s = (idx + std::countr_zero(cand)) & mask;
+        ROBINHOOD_STAT(++stats_.key_compares);
+        if (eq_(st.key(s), key)) {
+          ROBINHOOD_STAT(note_probe(first + std::countr_zero(cand)));
+          return s;
+        }
+      }
+      if (stop) {
+        // The first stop is where key belongs
+        unsigned i = static_cast<unsigned>(std::countr_zero(stop));
+        ROBINHOOD_STAT(note_probe(first + i));
+        if (plan)
+          find_gap(idx + i, first + i, *plan);
+        return SIZE_MAX;
+      }
+      idx = (idx + GROUP) & mask;
+    }
+    ROBINHOOD_STAT(note_probe(MAX_DIST));
+    return SIZE_MAX; // run longer than MAX_DIST: plan stays !ok
+  }
 
-    K ins_key = std::move(key);
-    V ins_val = std::move(value);
-    size_t ins_hash = h;
-    V *result = nullptr;  // will point to the originally inserted value
+  size_t locate(const K &key, InsertPlan *plan) const {
+    return locate_in(store_, ctrl_, mask_, key, hash_of(key), plan);
+  }
 
-    while (true) {
-      if (!slots_[idx].occupied) {
-        // Empty slot — place here
-        new (&slots_[idx].key) K(std::move(ins_key));
-        new (&slots_[idx].value) V(std::move(ins_val));
-        slots_[idx].hash = ins_hash;
-        slots_[idx].occupied = true;
-        ++size_;
-        if (!result) result = &slots_[idx].value;
-        return result;
-      }
+  size_t locate_old(const K &key) const {
+    return locate_in(old_.store, old_.ctrl, old_.mask, key, hash_of(key),
+                     nullptr);
+  }
 
-      // Check if this key already exists
-      if (slots_[idx].hash == ins_hash && eq_(slots_[idx].key, ins_key)) {
-        slots_[idx].value = std::move(ins_val);
-        return &slots_[idx].value;
-      }
+  size_t find_slot(const K &key) const { return locate(key, nullptr); }
 
-      // Robin Hood: evict if current occupant is richer (lower PSL)
-      size_t existing_psl = psl_at(idx);
-      if (existing_psl < psl) {
-        // Swap: we take this slot, displaced element continues probing
-        std::swap(ins_key, slots_[idx].key);
-        std::swap(ins_val, slots_[idx].value);
-        std::swap(ins_hash, slots_[idx].hash);
-        if (!result) result = &slots_[idx].value;
-        psl = existing_psl;
-      }
+  InsertPlan plan_for(const K &key) const {
+    InsertPlan plan;
+    locate(key, &plan);
+    return plan;
+  }
 
-      idx = (idx + 1) & mask_;
-      ++psl;
+  // Complete a plan for an entry going to pos with control byte dist:
+  // the next empty slot, and whether every entry shifted on the way can
+  // take one more step from home
+  void find_gap(size_t pos, unsigned dist, InsertPlan &plan) const {
+    plan.pos = pos & mask_;
+    plan.dist = dist;
+    if (dist > MAX_DIST) return;
+
+    // Load stays under MAX_LOAD, so an empty slot always turns up
+    size_t idx = plan.pos;
+    while (true) {
+      Group g(ctrl_ + idx);
+      uint32_t empty = g.match_empty();
+      uint32_t full = g.match_byte(MAX_DIST);
+      if (empty) {
+        if (full & ((empty & (0u - empty)) - 1u)) return;
+        plan.gap = (idx + std::countr_zero(empty)) & mask_;
+        plan.ok = true;
+        return;
+      }
+      if (full) return;
+      idx = (idx + GROUP) & mask_;
     }
   }
 
   // ---------------------------------------------------------------
-  //  Core find — returns slot index or SIZE_MAX
+  //  Core insert — key is known to be absent and plan came from the
+  //  probe that found that out. Returns the new entry's slot.
+  //
+  //  Within a cluster entries stay ordered by home slot, so Robin Hood
+  //  insertion is: shift the run from plan.pos up to plan.gap one step
+  //  right and construct the entry in the hole.
   // ---------------------------------------------------------------
-  size_t find_slot(const K &key) const {
-    if (capacity_ == 0) return SIZE_MAX;
+  template <typename KArg, typename... Args>
+  size_t insert_new(InsertPlan plan, KArg &&key, Args &&...args) {
+    // Re-plan after growing. A plan that is !ok at low load means a probe
+    // run about to overflow MAX_DIST: after mixing, only a Hash that gives
+    // hundreds of keys the same value does that, and growing can't help.
+    while (size_ >= grow_at_ || !plan.ok) {
+      if (size_ < grow_at_ && capacity_ >= (size_ + 1) * MAX_WEAK_SPREAD)
+        throw std::length_error(
+            "RobinHoodMap: over 240 keys share one hash value");
+      grow();
+      plan = plan_for(key);
+    }
+
+    size_t pos = plan.pos;
+    for (size_t j = plan.gap; j != pos;) {
+      size_t prev = (j - 1) & mask_;
+      new (&store_.key(j)) K(std::move(store_.key(prev)));
+      new (&store_.value(j)) V(std::move(store_.value(prev)));
+      store_.key(prev).~K();
+      store_.value(prev).~V();
+      set_ctrl(j, ctrl_[prev] + 1u);
+      j = prev;
+    }
 
-    size_t h = hasher_(key);
-    size_t idx = home_of(h);
-    size_t psl = 0;
+    new (&store_.key(pos)) K(std::forward<KArg>(key));
+    new (&store_.value(pos)) V(std::forward<Args>(args)...);
+    set_ctrl(pos, plan.dist);
+    ++size_;
+    return pos;
+  }
 
-    while (psl < capacity_) {
-      if (!slots_[idx].occupied)
-        return SIZE_MAX;  // empty slot = not found
+  // Slot of key in the current table, inserting it from args if it is in
+  // neither table. A key still in old_ is moved across first.
+  template <typename KArg, typename... Args>
+  std::pair<size_t, bool> emplace_slot(KArg &&key, Args &&...args) {
+    migrate(MIGRATE_STEP);
+    InsertPlan plan;
+    size_t idx = locate(key, &plan);
+    if (idx != SIZE_MAX) return {idx, false};
+
+    size_t old_idx = locate_old(key);
+    if (old_idx != SIZE_MAX) {
+      V value = std::move(old_.store.value(old_idx));
+      erase_at(old_.store, old_.ctrl, old_.mask, old_idx);
+      --old_.size;
+      --size_;
+      return {insert_new(plan, std::forward<KArg>(key), std::move(value)),
+              false};
+    }
+    return {insert_new(plan, std::forward<KArg>(key),
+                       std::forward<Args>(args)...),
+            true};
+  }
 
-      // Robin Hood early exit: if this occupant has a shorter probe
-      // length than ours, our key would have evicted it → not here
-      if (psl_at(idx) < psl)
-        return SIZE_MAX;
+  // Destroy the entry at idx and pull the rest of its run back one slot.
+  // Returns how many entries moved.
+  static size_t erase_at(Store st, uint8_t *ctrl, size_t mask, size_t idx) {
+    st.key(idx).~K();
+    st.value(idx).~V();
+
+    size_t shifted = 0;
+    size_t next = (idx + 1) & mask;
+    while (ctrl[next] > 1) {
+      ++shifted;
+      new (&st.key(idx)) K(std::move(st.key(next)));
+      new (&st.value(idx)) V(std::move(st.value(next)));
+      write_ctrl(ctrl, mask, idx, ctrl[next] - 1u);
+
+      st.key(next).~K();
+      st.value(next).~V();
+
+      idx = next;
+      next = (next + 1) & mask;
+    }
+    write_ctrl(ctrl, mask, idx, 0);
+    return shifted;
+  }
+
+  // Hint that the line holding p is about to be read
+  static void prefetch(const void *p) {
+#ifdef ROBINHOOD_SSE2
+    _mm_prefetch(static_cast<const char *>(p), _MM_HINT_T0);
+#elif defined(__GNUC__)
+    __builtin_prefetch(p);
+#else
+    (void)p;
+#endif
+  }
 
-      // Hash + key match
-      if (slots_[idx].hash == h && eq_(slots_[idx].key, key))
-        return idx;
+  static constexpr size_t BATCH = 16;
 
-      idx = (idx + 1) & mask_;
-      ++psl;
+  template <typename P>
+  size_t find_batched(std::span<const K> keys, std::span<P> out) const {
+    assert(out.size() >= keys.size());
+    if (!ctrl_) { // moved-from
+      std::fill_n(out.begin(), keys.size(), nullptr);
+      return 0;
+    }
+    size_t found = 0;
+    size_t hashes[BATCH];
+    for (size_t base = 0; base < keys.size(); base += BATCH) {
+      size_t n = std::min(BATCH, keys.size() - base);
+      // Pass 1: hash the block and start every home group's loads
+      for (size_t i = 0; i < n; ++i) {
+        hashes[i] = hash_of(keys[base + i]);
+        size_t home = hashes[i] & mask_;
+        prefetch(ctrl_ + home);
+        prefetch(&store_.key(home));
+        prefetch(&store_.value(home));
+      }
+      // Pass 2: resolve, by now mostly from cache
+      for (size_t i = 0; i < n; ++i) {
+        const K &key = keys[base + i];
+        P v = nullptr;
+        size_t idx = locate_in(store_, ctrl_, mask_, key, hashes[i], nullptr);
+        if (idx != SIZE_MAX) {
+          v = &store_.value(idx);
+        } else if (old_.ctrl) {
+          idx = locate_old(key);
+          if (idx != SIZE_MAX)
+            v = &old_.store.value(idx);
+        }
+        out[base + i] = v;
+        found += v != nullptr;
+      }
+    }
+    return found;
+  }
+
+  static void add_psl(std::vector<size_t> &hist, const uint8_t *ctrl,
+                      size_t cap) {
+    for (size_t i = 0; i < cap; ++i) {
+      if (!ctrl[i])
+        continue;
+      size_t psl = ctrl[i] - 1u;
+      if (psl >= hist.size())
+        hist.resize(psl + 1);
+      ++hist[psl];
     }
-    return SIZE_MAX;
   }
 
 public:
   // ---------------------------------------------------------------
-  //  Iterator — for range-for loops
+  //  Iterator — for range-for loops. Walks the current table, then
+  //  (mid-migration) whatever is left in the old one.
   // ---------------------------------------------------------------
   class iterator {
     friend class RobinHoodMap;
-    Slot *slots_;
-    size_t idx_, cap_;
+    Store store_, next_store_;
+    const uint8_t *ctrl_, *next_ctrl_;
+    size_t idx_, cap_, next_cap_;
 
     void skip_empty() {
-      while (idx_ < cap_ && !slots_[idx_].occupied) ++idx_;
+      while (true) {
+        while (idx_ < cap_ && !ctrl_[idx_]) ++idx_;
+        if (idx_ < cap_ || !next_ctrl_) return;
+        store_ = next_store_; ctrl_ = next_ctrl_; cap_ = next_cap_;
+        next_ctrl_ = nullptr;
+        idx_ = 0;
+      }
     }
 
   public:
-    iterator() : slots_(nullptr), idx_(0), cap_(0) {}
-    iterator(Slot *s, size_t i, size_t c) : slots_(s), idx_(i), cap_(c) {
+    iterator()
+        : ctrl_(nullptr), next_ctrl_(nullptr), idx_(0), cap_(0),
+          next_cap_(0) {}
+    iterator(Store s, const uint8_t *c, size_t i, size_t cap,
+             Store ns = Store{}, const uint8_t *nc = nullptr, size_t ncap = 0)
+        : store_(s), next_store_(ns), ctrl_(c), next_ctrl_(nc), idx_(i),
+          cap_(cap), next_cap_(ncap) {
       skip_empty();
     }
 
     std::pair<const K &, V &> operator*() const {
-      return {slots_[idx_].key, slots_[idx_].value};
+      return {store_.key(idx_), store_.value(idx_)};
     }
 
     iterator &operator++() { ++idx_; skip_empty(); return *this; }
-    bool operator==(const iterator &o) const { return idx_ == o.idx_; }
-    bool operator!=(const iterator &o) const { return idx_ != o.idx_; }
+    bool operator==(const iterator &o) const {
+      return idx_ == o.idx_ && ctrl_ == o.ctrl_;
+    }
+    bool operator!=(const iterator &o) const { return !(*this == o); }
   };
 
   class const_iterator {
     friend class RobinHoodMap;
-    const Slot *slots_;
-    size_t idx_, cap_;
+    Store store_, next_store_;
+    const uint8_t *ctrl_, *next_ctrl_;
+    size_t idx_, cap_, next_cap_;
 
     void skip_empty() {
-      while (idx_ < cap_ && !slots_[idx_].occupied) ++idx_;
+      while (true) {
+        while (idx_ < cap_ && !ctrl_[idx_]) ++idx_;
+        if (idx_ < cap_ || !next_ctrl_) return;
+        store_ = next_store_; ctrl_ = next_ctrl_; cap_ = next_cap_;
+        next_ctrl_ = nullptr;
+        idx_ = 0;
+      }
     }
 
   public:
-    const_iterator() : slots_(nullptr), idx_(0), cap_(0) {}
-    const_iterator(const Slot *s, size_t i, size_t c)
-        : slots_(s), idx_(i), cap_(c) { skip_empty(); }
+    const_iterator()
+        : ctrl_(nullptr), next_ctrl_(nullptr), idx_(0), cap_(0),
+          next_cap_(0) {}
+    const_iterator(Store s, const uint8_t *c, size_t i, size_t cap,
+                   Store ns = Store{}, const uint8_t *nc = nullptr,
+                   size_t ncap = 0)
+        : store_(s), next_store_(ns), ctrl_(c), next_ctrl_(nc), idx_(i),
+          cap_(cap), next_cap_(ncap) {
+      skip_empty();
+    }
 
     std::pair<const K &, const V &> operator*() const {
-      return {slots_[idx_].key, slots_[idx_].value};
+      return {store_.key(idx_), store_.value(idx_)};
     }
 
     const_iterator &operator++() { ++idx_; skip_empty(); return *this; }
-    bool operator==(const const_iterator &o) const { return idx_ == o.idx_; }
-    bool operator!=(const const_iterator &o) const { return idx_ != o.idx_; }
+    bool operator==(const const_iterator &o) const {
+      return idx_ == o.idx_ && ctrl_ == o.ctrl_;
+    }
+    bool operator!=(const const_iterator &o) const { return !(*this == o); }
   };
 
+private:
+  iterator at(size_t idx) {
+    return iterator(store_, ctrl_, idx, capacity_, old_.store, old_.ctrl,
+                    old_.capacity);
+  }
+  iterator at_old(size_t idx) {
+    return iterator(old_.store, old_.ctrl, idx, old_.capacity);
+  }
+  const_iterator at(size_t idx) const {
+    return const_iterator(store_, ctrl_, idx, capacity_, old_.store,
+                          old_.ctrl, old_.capacity);
+  }
+  const_iterator at_old(size_t idx) const {
+    return const_iterator(old_.store, old_.ctrl, idx, old_.capacity);
+  }
+
+public:
   // ---------------------------------------------------------------
   //  Constructors / Destructor
   // ---------------------------------------------------------------
@@ -289,19 +771,23 @@ public:
 
   // Move
   RobinHoodMap(RobinHoodMap &&o) noexcept
-      : slots_(o.slots_), capacity_(o.capacity_), mask_(o.mask_),
-        size_(o.size_), grow_at_(o.grow_at_) {
-    o.slots_ = nullptr; o.capacity_ = 0; o.mask_ = 0;
-    o.size_ = 0; o.grow_at_ = 0;
+      : store_(o.store_), ctrl_(o.ctrl_), capacity_(o.capacity_),
+        mask_(o.mask_), size_(o.size_), grow_at_(o.grow_at_), old_(o.old_),
+        incremental_(o.incremental_) {
+    o.store_ = Store{}; o.ctrl_ = nullptr; o.capacity_ = 0; o.mask_ = 0;
+    o.size_ = 0; o.grow_at_ = 0; o.old_ = OldTable{};
+    ROBINHOOD_STAT(stats_ = o.stats_; o.stats_ = {});
   }
 
   RobinHoodMap &operator=(RobinHoodMap &&o) noexcept {
     if (this != &o) {
       dealloc();
-      slots_ = o.slots_; capacity_ = o.capacity_; mask_ = o.mask_;
-      size_ = o.size_; grow_at_ = o.grow_at_;
-      o.slots_ = nullptr; o.capacity_ = 0; o.mask_ = 0;
-      o.size_ = 0; o.grow_at_ = 0;
+      store_ = o.store_; ctrl_ = o.ctrl_; capacity_ = o.capacity_;
+      mask_ = o.mask_; size_ = o.size_; grow_at_ = o.grow_at_;
+      old_ = o.old_; incremental_ = o.incremental_;
+      o.store_ = Store{}; o.ctrl_ = nullptr; o.capacity_ = 0; o.mask_ = 0;
+      o.size_ = 0; o.grow_at_ = 0; o.old_ = OldTable{};
+      ROBINHOOD_STAT(stats_ = o.stats_; o.stats_ = {});
     }
     return *this;
   }
@@ -314,31 +800,122 @@ public:
   //  Public API
   // ---------------------------------------------------------------
 
+  // Incremental rehash: a grow no longer moves every entry in one go.
+  // The old table is drained a few slots per insert/erase instead, and
+  // lookups check both tables until it is empty — bounded insert latency
+  // for a slightly slower miss while a migration is running. Turning it
+  // off finishes any migration in progress.
+  void set_incremental_rehash(bool on) {
+    incremental_ = on;
+    if (!on)
+      finish_migration();
+  }
+  bool incremental_rehash() const { return incremental_; }
+  bool migrating() const { return old_.ctrl != nullptr; }
+
   // Insert-or-access (like std::unordered_map::operator[])
   V &operator[](const K &key) {
-    size_t idx = find_slot(key);
-    if (idx != SIZE_MAX) return slots_[idx].value;
-    K k = key;
-    V v{};
-    return *do_insert(std::move(k), std::move(v));
+    return store_.value(emplace_slot(key).first);
+  }
+
+  // The inserting calls below all probe once: a miss remembers where the
+  // key belongs and constructs it there (a grow re-probes, as it must).
+  // args must not refer into this map — the insert may shift entries.
+
+  // Construct V from args only if key is absent
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(const K &key, Args &&...args) {
+    auto [idx, inserted] = emplace_slot(key, std::forward<Args>(args)...);
+    return {at(idx), inserted};
   }
 
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(K &&key, Args &&...args) {
+    auto [idx, inserted] =
+        emplace_slot(std::move(key), std::forward<Args>(args)...);
+    return {at(idx), inserted};
+  }
+
+  // Key built from key_arg; V from args if the key is new
+  template <typename KArg, typename... Args>
+  std::pair<iterator, bool> emplace(KArg &&key_arg, Args &&...args) {
+    return try_emplace(K(std::forward<KArg>(key_arg)),
+                       std::forward<Args>(args)...);
+  }
+
+  // Insert, or assign over the existing value. second: true if inserted.
+  template <typename M>
+  std::pair<iterator, bool> insert_or_assign(const K &key, M &&obj) {
+    auto [idx, inserted] = emplace_slot(key, std::forward<M>(obj));
+    if (!inserted)
+      store_.value(idx) = std::forward<M>(obj);
+    return {at(idx), inserted};
+  }
+
+  // Whether inserting key now would reallocate: the load limit is reached
+  // or its probe run is full. False if key is already present.
+  bool insert_grows(const K &key) const {
+    if (!ctrl_)
+      return true;
+    InsertPlan plan;
+    if (locate(key, &plan) != SIZE_MAX || locate_old(key) != SIZE_MAX)
+      return false;
+    return size_ >= grow_at_ || !plan.ok;
+  }
+
+  // Room for n entries without growing. Never shrinks.
+  void reserve(size_t n) {
+    size_t cap = capacity_for(n);
+    if (cap > capacity_) {
+      finish_migration();
+      rebuild(cap);
+    }
+  }
+
+  // Rebuild with at least n slots (and enough for size()); may shrink
+  void rehash(size_t n) {
+    finish_migration();
+    size_t cap = capacity_for(size_);
+    while (cap < n)
+      cap <<= 1;
+    if (cap != capacity_)
+      rebuild(cap);
+  }
+
+  void shrink_to_fit() { rehash(0); }
+
   // Find
   iterator find(const K &key) {
     size_t idx = find_slot(key);
-    if (idx == SIZE_MAX) return end();
-    return iterator(slots_, idx, capacity_);
+    if (idx != SIZE_MAX) return at(idx);
+    idx = locate_old(key);
+    if (idx != SIZE_MAX) return at_old(idx);
+    return end();
   }
 
   const_iterator find(const K &key) const {
     size_t idx = find_slot(key);
-    if (idx == SIZE_MAX) return end();
-    return const_iterator(slots_, idx, capacity_);
+    if (idx != SIZE_MAX) return at(idx);
+    idx = locate_old(key);
+    if (idx != SIZE_MAX) return at_old(idx);
+    return end();
+  }
+
+  // Batched find: out[i] = &value for keys[i], or nullptr if absent.
+  // Keys go in blocks of BATCH — hash the block, prefetch every home
+  // group, then resolve — so their cache misses overlap instead of each
+  // lookup waiting on its own. Returns how many were found.
+  size_t find_many(std::span<const K> keys, std::span<V *> out) {
+    return find_batched(keys, out);
+  }
+
+  size_t find_many(std::span<const K> keys, std::span<const V *> out) const {
+    return find_batched(keys, out);
   }
 
   // Count (0 or 1)
   size_t count(const K &key) const {
-    return find_slot(key) != SIZE_MAX ? 1 : 0;
+    return find_slot(key) != SIZE_MAX || locate_old(key) != SIZE_MAX ? 1 : 0;
   }
 
   size_t size() const { return size_; }
@@ -346,48 +923,79 @@ public:
 
   // Erase with backward-shift deletion
   bool erase(const K &key) {
+    migrate(MIGRATE_STEP);
     size_t idx = find_slot(key);
-    if (idx == SIZE_MAX) return false;
-
-    slots_[idx].key.~K();
-    slots_[idx].value.~V();
-    slots_[idx].occupied = false;
+    size_t shifted = 0;
+    if (idx != SIZE_MAX) {
+      shifted = erase_at(store_, ctrl_, mask_, idx);
+    } else {
+      idx = locate_old(key);
+      if (idx == SIZE_MAX)
+        return false;
+      shifted = erase_at(old_.store, old_.ctrl, old_.mask, idx);
+      --old_.size;
+    }
     --size_;
+    ROBINHOOD_STAT(++stats_.erases; stats_.erase_shifts += shifted;
+                   stats_.max_erase_shift =
+                       std::max<uint64_t>(stats_.max_erase_shift, shifted));
+    (void)shifted;
+    return true;
+  }
 
-    // Backward shift: pull subsequent displaced elements back
-    size_t next = (idx + 1) & mask_;
-    while (slots_[next].occupied && psl_at(next) > 0) {
-      size_t prev = (next + capacity_ - 1) & mask_;
-
-      new (&slots_[prev].key) K(std::move(slots_[next].key));
-      new (&slots_[prev].value) V(std::move(slots_[next].value));
-      slots_[prev].hash = slots_[next].hash;
-      slots_[prev].occupied = true;
-
-      slots_[next].key.~K();
-      slots_[next].value.~V();
-      slots_[next].occupied = false;
+  size_t capacity() const { return capacity_; }
+  float load_factor() const {
+    return capacity_ ? static_cast<float>(size_) / capacity_ : 0.0f;
+  }
 
-      next = (next + 1) & mask_;
-    }
-    return true;
+  // Telemetry: see RobinHoodStats (all zero without ROBINHOOD_STATS)
+  RobinHoodStats stats() const {
+#ifdef ROBINHOOD_STATS
+    return stats_;
+#else
+    return {};
+#endif
+  }
+  void reset_stats() { ROBINHOOD_STAT(stats_ = {}); }
+
+  // Diagnostic: result[d] = number of entries d slots from their home
+  std::vector<size_t> psl_histogram() const {
+    std::vector<size_t> hist;
+    if (ctrl_)
+      add_psl(hist, ctrl_, capacity_);
+    if (old_.ctrl)
+      add_psl(hist, old_.ctrl, old_.capacity);
+    return hist;
   }
 
   // Iterators
-  iterator begin() { return iterator(slots_, 0, capacity_); }
-  iterator end()   { return iterator(slots_, capacity_, capacity_); }
+  iterator begin() {
+    return iterator(store_, ctrl_, 0, capacity_, old_.store, old_.ctrl,
+                    old_.capacity);
+  }
+  iterator end() {
+    if (old_.ctrl)
+      return iterator(old_.store, old_.ctrl, old_.capacity, old_.capacity);
+    return iterator(store_, ctrl_, capacity_, capacity_);
+  }
 
-  const_iterator begin() const { return const_iterator(slots_, 0, capacity_); }
-  const_iterator end()   const { return const_iterator(slots_, capacity_, capacity_); }
+  const_iterator begin() const {
+    return const_iterator(store_, ctrl_, 0, capacity_, old_.store, old_.ctrl,
+                          old_.capacity);
+  }
+  const_iterator end() const {
+    if (old_.ctrl)
+      return const_iterator(old_.store, old_.ctrl, old_.capacity,
+                            old_.capacity);
+    return const_iterator(store_, ctrl_, capacity_, capacity_);
+  }
 
   // Clear
   void clear() {
-    for (size_t i = 0; i < capacity_; ++i) {
-      if (slots_[i].occupied) {
-        slots_[i].key.~K();
-        slots_[i].value.~V();
-        slots_[i].occupied = false;
-      }
+    drop_old();
+    if (ctrl_) {
+      destroy_entries(store_, ctrl_, capacity_);
+      std::memset(ctrl_, 0, capacity_ + GROUP);
     }
     size_ = 0;
   }
@@ -0,0 +1,118 @@
+#pragma once
+#include "RobinHoodMap.h"
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// ============================================================================
+//  RobinHoodSet — Keys-Only RobinHoodMap
+// ============================================================================
+//
+//  A RobinHoodMap whose value is an empty tag stored nowhere: the
+//  RobinHoodKeysOnly layout keeps just the key array, so a probe touches
+//  control bytes and keys and nothing else. Probing, growth, erase and
+//  incremental rehash are the map's own.
+//
+//  insert() is check-and-insert in one probe and reports whether the key
+//  was new, which is all a visited set needs.
+//
+// ============================================================================
+
+// Layout policy for an empty V: one key array, value() is a shared
+// instance. Constructing or destroying an empty trivial V touches no memory.
+struct RobinHoodKeysOnly {
+  template <typename K, typename V> class Storage {
+    static_assert(std::is_empty_v<V> && std::is_trivially_destructible_v<V>,
+                  "RobinHoodKeysOnly needs an empty value type");
+    K *keys_ = nullptr;
+
+  public:
+    void allocate(size_t cap) {
+      keys_ = static_cast<K *>(::operator new(sizeof(K) * cap));
+    }
+    void release() {
+      ::operator delete(keys_);
+      keys_ = nullptr;
+    }
+    bool allocated() const { return keys_ != nullptr; }
+
+    K &key(size_t i) const { return keys_[i]; }
+    static V &value(size_t) {
+      static V unit;
+      return unit;
+    }
+  };
+};
+
+template <typename K, typename Hash = std::hash<K>,
+          typename KeyEqual = std::equal_to<K>>
+class RobinHoodSet {
+  struct Unit {};
+  using Map = RobinHoodMap<K, Unit, Hash, KeyEqual, RobinHoodKeysOnly>;
+  Map map_;
+
+  // Wraps a map iterator and yields only the key
+  template <typename It> class Iter {
+    friend class RobinHoodSet;
+    It it_;
+    explicit Iter(It it) : it_(it) {}
+
+  public:
+    Iter() = default;
+    const K &operator*() const { return (*it_).first; }
+    Iter &operator++() { ++it_; return *this; }
+    bool operator==(const Iter &o) const { return it_ == o.it_; }
+    bool operator!=(const Iter &o) const { return it_ != o.it_; }
+  };
+
+public:
+  using iterator = Iter<typename Map::iterator>;
+  using const_iterator = Iter<typename Map::const_iterator>;
+
+  RobinHoodSet() = default;
+  explicit RobinHoodSet(size_t initial_cap) : map_(initial_cap) {}
+
+  // ---------------------------------------------------------------
+  //  Insert — one probe; second is true if the key was new
+  // ---------------------------------------------------------------
+  std::pair<iterator, bool> insert(const K &key) {
+    auto [it, inserted] = map_.try_emplace(key);
+    return {iterator(it), inserted};
+  }
+  std::pair<iterator, bool> insert(K &&key) {
+    auto [it, inserted] = map_.try_emplace(std::move(key));
+    return {iterator(it), inserted};
+  }
+
+  bool contains(const K &key) const { return map_.count(key) != 0; }
+  size_t count(const K &key) const { return map_.count(key); }
+  iterator find(const K &key) { return iterator(map_.find(key)); }
+  const_iterator find(const K &key) const {
+    return const_iterator(map_.find(key));
+  }
+  bool erase(const K &key) { return map_.erase(key); }
+
+  size_t size() const { return map_.size(); }
+  bool empty() const { return map_.empty(); }
+  size_t capacity() const { return map_.capacity(); }
+  float load_factor() const { return map_.load_factor(); }
+
+  void reserve(size_t n) { map_.reserve(n); }
+  void rehash(size_t n) { map_.rehash(n); }
+  void shrink_to_fit() { map_.shrink_to_fit(); }
+  void clear() { map_.clear(); }
+
+  void set_incremental_rehash(bool on) { map_.set_incremental_rehash(on); }
+
+  RobinHoodStats stats() const { return map_.stats(); }
+  void reset_stats() { map_.reset_stats(); }
+  std::vector<size_t> psl_histogram() const { return map_.psl_histogram(); }
+
+  iterator begin() { return iterator(map_.begin()); }
+  iterator end() { return iterator(map_.end()); }
+  const_iterator begin() const { return const_iterator(map_.begin()); }
+  const_iterator end() const { return const_iterator(map_.end()); }
+};
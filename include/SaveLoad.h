@@ -2,12 +2,16 @@
 #include "Chunk.h"
 #include "MobStorage.h"
 #include "World.h"
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
 #include <fstream>
-#include <memory>
 #include <string>
 
+// File layout: magic, header ints, chunks, mobs.
+//   "MC2D" — legacy, each chunk is 1024 raw BlockType bytes
+//   "MC2P" — each chunk is its PackedBlocks palette + packed index bytes
+
 inline bool save_game(const std::string &path, World &world, int px, int py,
                       int hp, int facing, int sel, int *inv,
                       MobStorage &mobs) {
@@ -15,9 +19,9 @@ inline bool save_game(const std::string &path, World &world, int px, int py,
   if (!f)
     return false;
 
-  f.write("MC2D", 4);
+  f.write("MC2P", 4);
 
-  int nc = static_cast<int>(world.chunk_count());
+  int nc = static_cast<int>(world.chunk_count() + world.spilled_count());
   f.write(reinterpret_cast<char *>(&nc), 4);
   f.write(reinterpret_cast<char *>(&px), 4);
   f.write(reinterpret_cast<char *>(&py), 4);
@@ -31,15 +35,16 @@ inline bool save_game(const std::string &path, World &world, int px, int py,
     f.write(reinterpret_cast<char *>(&cp.x), 4);
     f.write(reinterpret_cast<char *>(&cp.y), 4);
 
-    auto &blk = chunk_ptr->get_blocks();
-    for (int r = 0; r < CHUNK_SIZE; ++r) {
-      for (int c = 0; c < CHUNK_SIZE; ++c) {
-        uint8_t b = static_cast<uint8_t>(blk[r][c]);
-        f.write(reinterpret_cast<char *>(&b), 1);
-      }
-    }
+    write_packed_blocks(f, chunk_ptr->get_packed());
   }
 
+  // Modified chunks evicted to the spill store are part of the world too
+  world.for_each_spilled([&](Coord cp, const PackedBlocks &pb) {
+    f.write(reinterpret_cast<char *>(&cp.x), 4);
+    f.write(reinterpret_cast<char *>(&cp.y), 4);
+    write_packed_blocks(f, pb);
+  });
+
   int nm = static_cast<int>(mobs.count());
   f.write(reinterpret_cast<char *>(&nm), 4);
   for (int i = 0; i < nm; ++i) {
@@ -64,7 +69,8 @@ inline bool load_game(const std::string &path, World &world, int &px, int &py,
 
   char magic[4];
   f.read(magic, 4);
-  if (std::memcmp(magic, "MC2D", 4) != 0)
+  bool packed = std::memcmp(magic, "MC2P", 4) == 0;
+  if (!packed && std::memcmp(magic, "MC2D", 4) != 0)
     return false;
 
   int nc;
@@ -76,12 +82,26 @@ inline bool load_game(const std::string &path, World &world, int &px, int &py,
   f.read(reinterpret_cast<char *>(&sel), 4);
   f.read(reinterpret_cast<char *>(inv), 9 * 4);
 
+  if (nc < 0)
+    return false;
+
   world.clear();
+  world.reserve_chunks(static_cast<size_t>(std::min(nc, 1 << 16)));
   for (int i = 0; i < nc; ++i) {
     int cx, cy;
     f.read(reinterpret_cast<char *>(&cx), 4);
     f.read(reinterpret_cast<char *>(&cy), 4);
 
+    Coord pos = {cx, cy};
+
+    if (packed) {
+      PackedBlocks pb;
+      if (!read_packed_blocks(f, pb))
+        return false;
+      world.load_chunk(pos, std::move(pb));
+      continue;
+    }
+
     std::array<std::array<BlockType, CHUNK_SIZE>, CHUNK_SIZE> blk;
     for (int r = 0; r < CHUNK_SIZE; ++r) {
       for (int c = 0; c < CHUNK_SIZE; ++c) {
@@ -91,8 +111,7 @@ inline bool load_game(const std::string &path, World &world, int &px, int &py,
       }
     }
 
-    Coord pos = {cx, cy};
-    world.load_chunk(pos, std::make_unique<Chunk>(pos, std::move(blk)));
+    world.load_chunk(pos, PackedBlocks(blk));
   }
 
   mobs.x.clear();
@@ -1,5 +1,6 @@
 #pragma once
 #include "BlockType.h"
+#include <array>
 #include <cmath>
 #include <cstdint>
 #include <cstring>
@@ -110,6 +111,15 @@ inline float fbm_2d(float x, float y, int seed, int octaves = 4) {
   return value / max_amplitude;
 }
 
+// Terrain only varies inside chunk row 0. Everything above it is open sky
+// and everything below solid bedrock, so those chunks are uniform.
+inline bool chunk_is_uniform(int cy, BlockType &fill) {
+  if (cy == 0)
+    return false;
+  fill = (cy < 0) ? BlockType::AIR : BlockType::BEDROCK;
+  return true;
+}
+
 inline void generate_chunk_terrain(
     std::array<std::array<BlockType, CHUNK_SIZE>, CHUNK_SIZE> &blocks, int cx,
     int seed = 42) {
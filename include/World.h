@@ -1,27 +1,204 @@
 #pragma once
 #include "BlockType.h"
 #include "Chunk.h"
+#include "ChunkGenerator.h"
+#include "ChunkPool.h"
+#include "ChunkStore.h"
 #include "Coord.h"
+#include "MoveMasks.h"
 #include "Pixel.h"
+#include "Reachability.h"
 #include "RobinHoodMap.h"
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstdlib>
 #include <iostream>
 #include <memory>
+#include <optional>
+#include <string>
+#include <utility>
 
 class World {
 private:
-  RobinHoodMap<Coord, std::unique_ptr<Chunk>, CoordHash> chunks;
+  ChunkPool pool; // owns every Chunk the map points to
+  RobinHoodMap<Coord, Chunk *, CoordHash> chunks;
+  size_t lookup_count_ = 0; // chunk map probes, for benchmarks/profiling
+
+  // ---- residency: LRU list through Chunk::lru_prev/lru_next ----
+  size_t max_resident_ = 0; // 0 = unbounded
+  Chunk *lru_head_ = nullptr; // most recently used
+  Chunk *lru_tail_ = nullptr;
+  Coord pin_center_ = {0, 0}; // chunk coord the player is in
+  int pin_radius_ = -1;       // in chunks; -1 = nothing pinned
+  std::string spill_path_; // empty = ChunkStore::scratch_path() on first spill
+  std::unique_ptr<ChunkStore> spill_;
+  uint64_t epoch_ = 0; // bumped whenever a resident chunk is destroyed
+  size_t evictions_ = 0;
+  size_t spill_writes_ = 0;
+  size_t faults_ = 0;
+
+  // ---- background generation (off unless enable_async_generation) ----
+  std::unique_ptr<ChunkGenerator> gen_;
+  RobinHoodMap<Coord, bool, CoordHash> pending_; // requested, not installed
+
+  // ---- per-frame budget for try_ reads that may load chunks ----
+  size_t gen_budget_ = DEFAULT_GENERATION_BUDGET;
+  size_t gen_budget_left_ = DEFAULT_GENERATION_BUDGET;
+  size_t budget_refusals_ = 0;
+
+  // ---- air connectivity, built on the first may_reach() ----
+  ReachabilityIndex reach_;
+
+  // ---- per-cell legal moves, built on the first move_mask() ----
+  MoveMaskIndex moves_;
+
+  // Bumped whenever what a non-generating search sees may have changed:
+  // a cell flips between air and solid, or a chunk arrives or leaves
+  uint64_t edit_epoch_ = 0;
 
 public:
+  class Cursor;
+
+  // Chunk loads (generate or fault in) try_ reads may trigger per frame
+  static constexpr size_t DEFAULT_GENERATION_BUDGET = 2;
+
+  // What a try_ read does when the chunk it needs isn't resident
+  enum class Generate {
+    NO,           // report "not loaded"
+    WITHIN_BUDGET // load it if this frame's budget allows
+  };
+
+  // ~2.3 MB of pooled chunks; a screen plus mob radius needs well under 100
+  static constexpr size_t DEFAULT_MAX_RESIDENT = 4096;
+
+  // copy_region fills cells of chunks still being generated with this
+  static constexpr BlockType PENDING = BlockType::COUNT;
+
+  // A grow of the chunk map is spread over the following inserts instead
+  // of rehashing every resident chunk inside one frame
+  World() { chunks.set_incremental_rehash(true); }
+  ~World() { clear(); }
+
+  World(const World &) = delete;
+  World &operator=(const World &) = delete;
+
+  // Uniform sky/bedrock chunks nobody has edited are not stored: every
+  // lookup of one returns the same shared read-only chunk for its fill.
   Chunk &get_chunk(Coord pos) {
+    ++lookup_count_;
     auto it = chunks.find(pos);
     if (it == chunks.end()) {
-      chunks[pos] = std::make_unique<Chunk>(pos);
-      return *chunks[pos];
+      if (Chunk *u = shared_uniform(pos))
+        return *u;
+      Chunk *c = fault_in(pos);
+      chunks.try_emplace(pos, c);
+      lru_push_front(c);
+      reach_.installed(pos, c);
+      moves_.installed(pos, chunk_reader());
+      ++edit_epoch_;
+      enforce_cap();
+      return *c;
     }
     auto [key, val] = *it;
-    return *val;
+    return *touch(val);
   }
 
+  // ---------------------------------------------------------------
+  //  Non-generating reads for AI, spawning and anything else outside
+  //  the camera area. A chunk that isn't resident (or shared uniform)
+  //  is reported as not loaded; with Generate::WITHIN_BUDGET it is
+  //  loaded instead while this frame's budget lasts. Under async
+  //  generation the load is queued on the worker and still reported
+  //  as not loaded this time.
+  // ---------------------------------------------------------------
+  Chunk *try_get_chunk(Coord pos, Generate gen = Generate::NO) {
+    ++lookup_count_;
+    auto it = chunks.find(pos);
+    if (it != chunks.end()) {
+      auto [key, val] = *it;
+      return touch(val);
+    }
+    if (Chunk *u = shared_uniform(pos))
+      return u;
+    if (gen == Generate::NO)
+      return nullptr;
+
+    bool spilled = spill_ && spill_->contains(pos);
+    if (gen_ && !spilled && pending_.count(pos))
+      return nullptr; // already queued, costs nothing more
+    if (gen_budget_left_ == 0) {
+      ++budget_refusals_;
+      return nullptr;
+    }
+    --gen_budget_left_;
+    if (gen_ && !spilled) {
+      prefetch(pos);
+      return nullptr;
+    }
+    return &get_chunk(pos);
+  }
+
+  // The chunk a non-generating read sees at pos, without touching the
+  // LRU order; nullptr if not loaded
+  const Chunk *peek_chunk(Coord pos) const {
+    auto it = chunks.find(pos);
+    if (it != chunks.end())
+      return (*it).second;
+    return shared_uniform(pos);
+  }
+
+  std::optional<BlockType> try_get_block(int wx, int wy,
+                                         Generate gen = Generate::NO) {
+    Coord cp = world_to_chunk(wx, wy);
+    Chunk *c = try_get_chunk(cp, gen);
+    if (!c)
+      return std::nullopt;
+    return c->get_block(wx - cp.x * CHUNK_SIZE, wy - cp.y * CHUNK_SIZE);
+  }
+
+  std::optional<bool> try_is_air(int wx, int wy,
+                                 Generate gen = Generate::NO) {
+    Coord cp = world_to_chunk(wx, wy);
+    Chunk *c = try_get_chunk(cp, gen);
+    if (!c)
+      return std::nullopt;
+    return c->is_air(wx - cp.x * CHUNK_SIZE, wy - cp.y * CHUNK_SIZE);
+  }
+
+  // First solid y in column wx within [wy, max_wy], or max_wy + 1 if the
+  // span is all air; nullopt if a chunk on the way isn't loaded. Reads one
+  // solidity column per chunk and takes its lowest set bit.
+  std::optional<int> try_first_solid_below(int wx, int wy, int max_wy,
+                                           Generate gen = Generate::NO) {
+    while (wy <= max_wy) {
+      Coord cp = world_to_chunk(wx, wy);
+      Chunk *c = try_get_chunk(cp, gen);
+      if (!c)
+        return std::nullopt;
+      int ly = wy - cp.y * CHUNK_SIZE;
+      uint32_t below = c->solid_column(wx - cp.x * CHUNK_SIZE) >> ly;
+      if (below) {
+        int y = wy + std::countr_zero(below);
+        return y <= max_wy ? y : max_wy + 1;
+      }
+      wy += CHUNK_SIZE - ly;
+    }
+    return max_wy + 1;
+  }
+
+  // Call once per frame to refill the generation budget
+  void begin_frame() { gen_budget_left_ = gen_budget_; }
+
+  void set_generation_budget(size_t per_frame) {
+    gen_budget_ = per_frame;
+    gen_budget_left_ = std::min(gen_budget_left_, per_frame);
+  }
+
+  size_t generation_budget() const { return gen_budget_; }
+  size_t generation_budget_left() const { return gen_budget_left_; }
+  size_t budget_refusal_count() const { return budget_refusals_; }
+
   BlockType get_block(int wx, int wy) {
     Coord chunk_pos = world_to_chunk(wx, wy);
     int cx = wx % CHUNK_SIZE;
@@ -33,6 +210,12 @@ public:
     return get_chunk(chunk_pos).get_block(cx, cy);
   }
 
+  // get_block(wx, wy) == AIR as a single bit test
+  bool is_air(int wx, int wy) {
+    Coord cp = world_to_chunk(wx, wy);
+    return get_chunk(cp).is_air(wx - cp.x * CHUNK_SIZE, wy - cp.y * CHUNK_SIZE);
+  }
+
   void set_block(int wx, int wy, BlockType type) {
     Coord chunk_pos = world_to_chunk(wx, wy);
     int cx = wx % CHUNK_SIZE;
@@ -41,21 +224,393 @@ public:
       cx += CHUNK_SIZE;
     if (cy < 0)
       cy += CHUNK_SIZE;
-    get_chunk(chunk_pos).set_block(cx, cy, type);
+    Chunk &c = get_chunk_for_write(chunk_pos);
+    bool was_air = c.is_air(cx, cy);
+    c.set_block(cx, cy, type);
+    if (was_air != (type == BlockType::AIR)) {
+      reach_.changed(chunk_pos, cx, cy, type == BlockType::AIR);
+      moves_.changed(wx, wy, chunk_reader());
+      ++edit_epoch_;
+    }
   }
 
+  // false only if no path of air cells leads from a to b, so no search
+  // from a to b can succeed; b must be air. Sees the world as
+  // bfs_findpath does: chunks that aren't loaded are solid. The first call
+  // indexes every resident chunk; later ones redo only what changed.
+  bool may_reach(Coord a, Coord b) {
+    if (!reach_.active()) {
+      reach_.activate();
+      for (auto [pos, c] : chunks)
+        reach_.installed(pos, c);
+    }
+    return reach_.may_reach(a, b, [this](Coord pos) {
+      const Chunk *u = shared_uniform(pos);
+      return u && u->is_air(0, 0);
+    });
+  }
+
+  const ReachabilityIndex &reachability() const { return reach_; }
+
+  // can_step for all eight moves from cell, bit m = PATH_DIRS[m], with
+  // bfs_findpath's view of the world. The first call tables every
+  // resident chunk; after that the tables follow every edit, load and
+  // eviction. World::Cursor::moves reads them through its chunk cache.
+  uint8_t move_mask(Coord cell) {
+    activate_move_masks();
+    return moves_.mask(cell, chunk_reader());
+  }
+
+  const MoveMaskIndex &move_masks() const { return moves_; }
+
+  // Unchanged since a search ran = the search would find the same result.
+  // Path caches compare it to skip revalidating.
+  uint64_t edit_epoch() const { return edit_epoch_; }
+
+  // Fill out[row * w + col] with the w x h blocks whose top-left is
+  // (x0, y0). Each chunk is looked up once and decoded a row span at a time.
+  // With wait == false, chunks not generated yet are queued in the
+  // background and their cells set to PENDING; returns false if any were.
+  bool copy_region(int x0, int y0, int w, int h, BlockType *out,
+                   bool wait = true) {
+    bool complete = true;
+    int y = y0;
+    while (y < y0 + h) {
+      Coord row_chunk = world_to_chunk(x0, y);
+      int ly = y - row_chunk.y * CHUNK_SIZE;
+      int rows = std::min(CHUNK_SIZE - ly, y0 + h - y);
+
+      int x = x0;
+      while (x < x0 + w) {
+        Coord cp = {world_to_chunk(x, y).x, row_chunk.y};
+        int lx = x - cp.x * CHUNK_SIZE;
+        int cols = std::min(CHUNK_SIZE - lx, x0 + w - x);
+
+        const Chunk *chunk = wait ? &get_chunk(cp) : get_chunk_if_ready(cp);
+        BlockType *dst = out + static_cast<size_t>(y - y0) * w + (x - x0);
+        for (int r = 0; r < rows; ++r) {
+          if (chunk) {
+            chunk->copy_row(lx, ly + r, cols, dst);
+          } else {
+            std::fill_n(dst, cols, PENDING);
+          }
+          dst += w;
+        }
+        complete = complete && chunk;
+        x += cols;
+      }
+      y += rows;
+    }
+    return complete;
+  }
+
+  // ---------------------------------------------------------------
+  //  Background generation: prefetch() queues chunks on a worker,
+  //  pump_generated() installs finished ones on the calling thread.
+  // ---------------------------------------------------------------
+  void enable_async_generation() {
+    if (!gen_)
+      gen_ = std::make_unique<ChunkGenerator>();
+  }
+
+  bool async_generation() const { return gen_ != nullptr; }
+
+  // Resident chunk, or a spilled one faulted in from disk. A chunk that
+  // would need generating is queued instead and nullptr returned.
+  Chunk *get_chunk_if_ready(Coord pos) {
+    BlockType fill;
+    if (!gen_ || chunks.count(pos) || (spill_ && spill_->contains(pos)) ||
+        chunk_is_uniform(pos.y, fill))
+      return &get_chunk(pos);
+    prefetch(pos);
+    return nullptr;
+  }
+
+  void prefetch(Coord pos) {
+    BlockType fill;
+    if (!gen_ || chunks.count(pos) || (spill_ && spill_->contains(pos)) ||
+        chunk_is_uniform(pos.y, fill))
+      return;
+    if (!pending_.try_emplace(pos, true).second)
+      return; // already queued
+    gen_->request(pos);
+  }
+
+  // Queue every chunk overlapping the w x h block rectangle at (x0, y0)
+  void prefetch_region(int x0, int y0, int w, int h) {
+    Coord lo = world_to_chunk(x0, y0);
+    Coord hi = world_to_chunk(x0 + w - 1, y0 + h - 1);
+    for (int cy = lo.y; cy <= hi.y; ++cy) {
+      for (int cx = lo.x; cx <= hi.x; ++cx) {
+        prefetch({cx, cy});
+      }
+    }
+  }
+
+  // Install chunks the worker has finished. A chunk that became resident
+  // (or was spilled) in the meantime wins over the freshly generated copy.
+  size_t pump_generated() {
+    if (!gen_)
+      return 0;
+    size_t installed = 0;
+    gen_->collect([&](Coord pos, PackedBlocks &&blocks) {
+      pending_.erase(pos);
+      if (spill_ && spill_->contains(pos))
+        return;
+      auto [it, inserted] = chunks.try_emplace(pos, nullptr);
+      if (!inserted)
+        return;
+      Chunk *c = pool.create(pos, std::move(blocks));
+      (*it).second = c;
+      lru_push_front(c);
+      reach_.installed(pos, c);
+      moves_.installed(pos, chunk_reader());
+      ++edit_epoch_;
+      ++installed;
+    });
+    if (installed)
+      enforce_cap();
+    return installed;
+  }
+
+  size_t pending_count() const { return pending_.size(); }
+
   size_t chunk_count() const { return chunks.size(); }
 
+  // The chunk index itself, for telemetry (stats(), psl_histogram())
+  const RobinHoodMap<Coord, Chunk *, CoordHash> &chunk_map() const {
+    return chunks;
+  }
+
+  size_t lookup_count() const { return lookup_count_; }
+  void reset_lookup_count() { lookup_count_ = 0; }
+
   auto begin() { return chunks.begin(); }
   auto end() { return chunks.end(); }
 
-  void load_chunk(Coord pos, std::unique_ptr<Chunk> c) {
-    chunks[pos] = std::move(c);
+  // Install saved blocks at pos, replacing any chunk already there
+  void load_chunk(Coord pos, PackedBlocks blocks) {
+    bool was_shared = shared_uniform(pos) != nullptr;
+    if (spill_)
+      spill_->erase(pos);
+    Chunk *c = pool.create(pos, std::move(blocks));
+    c->modified = true; // can't be regenerated from the seed
+    auto [it, inserted] = chunks.try_emplace(pos, c);
+    if (!inserted) {
+      Chunk *old = std::exchange((*it).second, c);
+      lru_unlink(old);
+      pool.destroy(old);
+    }
+    if (!inserted || was_shared)
+      ++epoch_; // Cursors may hold the chunk pos was served by
+    lru_push_front(c);
+    reach_.installed(pos, c);
+    moves_.installed(pos, chunk_reader());
+    ++edit_epoch_;
+    enforce_cap();
+  }
+
+  // Make room for n chunks up front (load_game knows the count)
+  void reserve_chunks(size_t n) {
+    size_t resident = max_resident_ ? std::min(n, max_resident_) : n;
+    pool.reserve(resident);
+    chunks.reserve(resident);
   }
 
-  void clear() { chunks.clear(); }
+  size_t pool_bytes() const { return pool.reserved_bytes(); }
+
+  // Chunks go back to the pool's free list; the next load reuses them.
+  // Walking the LRU list from the head (not the map, which is in hash
+  // order) leaves the oldest chunk's slot on top, so a reload hands out
+  // slots in the order they were first filled.
+  void clear() {
+    for (Chunk *c = lru_head_; c;) {
+      Chunk *next = c->lru_next;
+      pool.destroy(c);
+      c = next;
+    }
+    chunks.clear();
+    reach_.clear();
+    moves_.clear();
+    ++edit_epoch_;
+    lru_head_ = lru_tail_ = nullptr;
+    if (spill_)
+      spill_->clear();
+    ++epoch_;
+  }
+
+  // ---------------------------------------------------------------
+  //  Residency: cap resident chunks, evict least recently used.
+  //  Unmodified chunks are dropped (regenerated on demand); modified
+  //  ones are spilled to disk and faulted back in by get_chunk.
+  // ---------------------------------------------------------------
+  void set_max_resident(size_t n) {
+    max_resident_ = n;
+    enforce_cap();
+  }
+
+  size_t max_resident() const { return max_resident_; }
+
+  // Chunks within radius blocks of (wx, wy) are never evicted
+  void set_pin_area(int wx, int wy, int radius) {
+    pin_center_ = world_to_chunk(wx, wy);
+    pin_radius_ = (radius + CHUNK_SIZE - 1) / CHUNK_SIZE;
+  }
+
+  // Spill to this file instead of a private one in the temp directory;
+  // takes effect at the first spill
+  void set_spill_path(std::string path) { spill_path_ = std::move(path); }
+
+  size_t spilled_count() const { return spill_ ? spill_->size() : 0; }
+  size_t eviction_count() const { return evictions_; }
+  size_t spill_write_count() const { return spill_writes_; }
+  size_t fault_count() const { return faults_; }
+
+  template <typename Fn> void for_each_spilled(Fn &&fn) {
+    if (spill_)
+      spill_->for_each(fn);
+  }
 
 private:
+  // One immutable chunk per uniform fill, shared by every World
+  static Chunk *uniform_chunk(BlockType fill) {
+    auto make = [](BlockType f) {
+      Chunk c({0, 0}, PackedBlocks(f));
+      c.shared = true;
+      return c;
+    };
+    static Chunk air = make(BlockType::AIR);
+    static Chunk bedrock = make(BlockType::BEDROCK);
+    return fill == BlockType::AIR ? &air : &bedrock;
+  }
+
+  // Shared stand-in for an unstored uniform chunk, or nullptr if pos has
+  // (or had, before being spilled) chunk-specific content
+  Chunk *shared_uniform(Coord pos) const {
+    BlockType fill;
+    if (!chunk_is_uniform(pos.y, fill) || (spill_ && spill_->contains(pos)))
+      return nullptr;
+    return uniform_chunk(fill);
+  }
+
+  // How moves_ reads the world
+  struct ChunkReader {
+    const World *world;
+    const Chunk *operator()(Coord pos) const { return world->peek_chunk(pos); }
+  };
+  ChunkReader chunk_reader() const { return {this}; }
+
+  void activate_move_masks() {
+    if (moves_.active())
+      return;
+    moves_.activate();
+    for (auto [pos, c] : chunks)
+      moves_.installed(pos, chunk_reader());
+  }
+
+  // get_chunk, but a shared uniform chunk is first copied into a private
+  // pooled chunk of its own (copy-on-write). Bumps the epoch so cursors
+  // holding the shared chunk for pos re-resolve and see the edit.
+  Chunk &get_chunk_for_write(Coord pos) {
+    Chunk &c = get_chunk(pos);
+    if (!c.shared)
+      return c;
+    Chunk *own = pool.create(pos, c.get_packed());
+    chunks.try_emplace(pos, own);
+    lru_push_front(own);
+    reach_.installed(pos, own);
+    moves_.installed(pos, chunk_reader());
+    ++epoch_;
+    enforce_cap();
+    return *own;
+  }
+
+  // Mark a resident chunk most recently used
+  Chunk *touch(Chunk *c) {
+    if (c != lru_head_) {
+      lru_unlink(c);
+      lru_push_front(c);
+    }
+    return c;
+  }
+
+  Chunk *fault_in(Coord pos) {
+    PackedBlocks blocks;
+    if (spill_ && spill_->take(pos, blocks)) {
+      ++faults_;
+      Chunk *c = pool.create(pos, std::move(blocks));
+      c->modified = true;
+      return c;
+    }
+    return pool.create(pos);
+  }
+
+  bool pinned(Coord cp) const {
+    return pin_radius_ >= 0 && std::abs(cp.x - pin_center_.x) <= pin_radius_ &&
+           std::abs(cp.y - pin_center_.y) <= pin_radius_;
+  }
+
+  void lru_unlink(Chunk *c) {
+    if (c->lru_prev)
+      c->lru_prev->lru_next = c->lru_next;
+    else
+      lru_head_ = c->lru_next;
+    if (c->lru_next)
+      c->lru_next->lru_prev = c->lru_prev;
+    else
+      lru_tail_ = c->lru_prev;
+    c->lru_prev = c->lru_next = nullptr;
+  }
+
+  void lru_push_front(Chunk *c) {
+    c->lru_prev = nullptr;
+    c->lru_next = lru_head_;
+    if (lru_head_)
+      lru_head_->lru_prev = c;
+    lru_head_ = c;
+    if (!lru_tail_)
+      lru_tail_ = c;
+  }
+
+  void destroy_resident(Chunk *c) {
+    lru_unlink(c);
+    chunks.erase(c->get_position());
+    reach_.removed(c->get_position());
+    moves_.removed(c->get_position(), chunk_reader());
+    ++edit_epoch_;
+    pool.destroy(c);
+    ++epoch_;
+  }
+
+  // Walk from the cold end, skipping pinned chunks and the chunk just used.
+  // If everything left is pinned the cap is exceeded rather than violated.
+  void enforce_cap() {
+    if (max_resident_ == 0)
+      return;
+    Chunk *c = lru_tail_;
+    while (chunks.size() > max_resident_ && c && c != lru_head_) {
+      Chunk *prev = c->lru_prev;
+      if (!pinned(c->get_position()))
+        evict(c);
+      c = prev;
+    }
+  }
+
+  void evict(Chunk *c) {
+    if (c->modified) {
+      if (!spill_)
+        spill_ = std::make_unique<ChunkStore>(
+            spill_path_.empty() ? ChunkStore::scratch_path() : spill_path_);
+      if (!spill_->put(c->get_position(), c->get_packed()))
+        return; // no disk to spill to: keep it resident
+      ++spill_writes_;
+    }
+    destroy_resident(c);
+    ++evictions_;
+  }
+
+public:
+  // Chunk containing world cell (wx, wy)
   static Coord world_to_chunk(int wx, int wy) {
     int cx, cy;
 
@@ -75,6 +630,159 @@ private:
   }
 };
 
+// ============================================================================
+//  World::Cursor — block access with a cached chunk
+// ============================================================================
+//
+//  Remembers the last chunk it touched and its world-space origin, so runs
+//  of accesses inside one chunk skip the hash probe and the signed div/mod.
+//  Only leaving the chunk costs a World::get_chunk lookup.
+//
+//  seek() + up/down/left/right() peek at neighbours of a fixed cell; a peek
+//  that crosses a chunk border does a lookup but keeps the cached chunk, so
+//  border cells don't thrash the cache.
+//
+//  Any eviction, clear(), or load_chunk() over a resident or shared chunk
+//  bumps the World's epoch, which drops the cached chunk on the next
+//  access.
+//
+//  moves() keeps the cached chunk's move-mask table next to it.
+//
+// ============================================================================
+
+class World::Cursor {
+  World &world_;
+  Chunk *chunk_ = nullptr;
+  uint64_t epoch_ = 0; // world epoch when chunk_ was cached
+  int base_x_ = 0; // world coord of the cached chunk's (0, 0)
+  int base_y_ = 0;
+  int x_ = 0;      // seek() position
+  int y_ = 0;
+  const Chunk *table_chunk_ = nullptr; // chunk table_ belongs to
+  uint64_t table_epoch_ = 0;
+  const uint8_t *table_ = nullptr; // its move masks, if it has them
+
+  bool in_cached(int wx, int wy) const {
+    return chunk_ && epoch_ == world_.epoch_ &&
+           static_cast<unsigned>(wx - base_x_) < CHUNK_SIZE &&
+           static_cast<unsigned>(wy - base_y_) < CHUNK_SIZE;
+  }
+
+  Chunk &load(int wx, int wy) {
+    Coord cp = World::world_to_chunk(wx, wy);
+    chunk_ = &world_.get_chunk(cp);
+    epoch_ = world_.epoch_;
+    base_x_ = cp.x * CHUNK_SIZE;
+    base_y_ = cp.y * CHUNK_SIZE;
+    return *chunk_;
+  }
+
+  // load() without generating; false (cache untouched) if not loaded
+  bool try_load(int wx, int wy, Generate gen) {
+    Coord cp = World::world_to_chunk(wx, wy);
+    Chunk *c = world_.try_get_chunk(cp, gen);
+    if (!c)
+      return false;
+    chunk_ = c;
+    epoch_ = world_.epoch_;
+    base_x_ = cp.x * CHUNK_SIZE;
+    base_y_ = cp.y * CHUNK_SIZE;
+    return true;
+  }
+
+  // Read without replacing the cached chunk
+  BlockType peek(int wx, int wy) {
+    if (in_cached(wx, wy))
+      return chunk_->get_block(wx - base_x_, wy - base_y_);
+    return world_.get_block(wx, wy);
+  }
+
+public:
+  explicit Cursor(World &w) : world_(w) {}
+
+  bool is_air(int wx, int wy) {
+    if (!in_cached(wx, wy))
+      load(wx, wy);
+    return chunk_->is_air(wx - base_x_, wy - base_y_);
+  }
+
+  // World::try_is_air through the cache
+  std::optional<bool> try_is_air(int wx, int wy, Generate gen = Generate::NO) {
+    if (in_cached(wx, wy) || try_load(wx, wy, gen))
+      return chunk_->is_air(wx - base_x_, wy - base_y_);
+    return std::nullopt;
+  }
+
+  // World::try_get_block through the cache; misses don't replace it
+  std::optional<BlockType> try_get_block(int wx, int wy,
+                                         Generate gen = Generate::NO) {
+    if (in_cached(wx, wy) || try_load(wx, wy, gen))
+      return chunk_->get_block(wx - base_x_, wy - base_y_);
+    return std::nullopt;
+  }
+
+  BlockType get_block(int wx, int wy) {
+    if (!in_cached(wx, wy))
+      load(wx, wy);
+    return chunk_->get_block(wx - base_x_, wy - base_y_);
+  }
+
+  void set_block(int wx, int wy, BlockType type) {
+    if (!in_cached(wx, wy))
+      load(wx, wy);
+    if (chunk_->shared) {
+      chunk_ = &world_.get_chunk_for_write(
+          {base_x_ / CHUNK_SIZE, base_y_ / CHUNK_SIZE});
+      epoch_ = world_.epoch_;
+    }
+    int lx = wx - base_x_, ly = wy - base_y_;
+    bool was_air = chunk_->is_air(lx, ly);
+    chunk_->set_block(lx, ly, type);
+    if (was_air != (type == BlockType::AIR)) {
+      world_.reach_.changed({base_x_ / CHUNK_SIZE, base_y_ / CHUNK_SIZE}, lx,
+                            ly, type == BlockType::AIR);
+      world_.moves_.changed(wx, wy, world_.chunk_reader());
+      ++world_.edit_epoch_;
+    }
+  }
+
+  // World::move_mask through the cache: one byte read while the cell's
+  // chunk is cached and tabled. Never generates.
+  uint8_t moves(int wx, int wy) {
+    if (!world_.moves_.active())
+      world_.activate_move_masks();
+    if (in_cached(wx, wy) || try_load(wx, wy, Generate::NO)) {
+      if (table_chunk_ != chunk_ || table_epoch_ != epoch_) {
+        table_chunk_ = chunk_;
+        table_epoch_ = epoch_;
+        table_ = world_.moves_.table(
+            {base_x_ / CHUNK_SIZE, base_y_ / CHUNK_SIZE});
+      }
+      if (table_)
+        return table_[(wy - base_y_) * CHUNK_SIZE + (wx - base_x_)];
+    }
+    return world_.moves_.mask({wx, wy}, world_.chunk_reader());
+  }
+
+  // Move to a cell and cache its chunk
+  void seek(int wx, int wy) {
+    x_ = wx;
+    y_ = wy;
+    if (!in_cached(wx, wy))
+      load(wx, wy);
+  }
+
+  BlockType get() {
+    if (!in_cached(x_, y_))
+      load(x_, y_);
+    return chunk_->get_block(x_ - base_x_, y_ - base_y_);
+  }
+  BlockType up() { return peek(x_, y_ - 1); }
+  BlockType down() { return peek(x_, y_ + 1); }
+  BlockType left() { return peek(x_ - 1, y_); }
+  BlockType right() { return peek(x_ + 1, y_); }
+};
+
 inline void print_world(World &world, int min_x, int max_x, int min_y,
                         int max_y) {
   for (int y = min_y; y <= max_y; ++y) {
@@ -0,0 +1,484 @@
+#pragma once
+#include "BlockType.h"
+#include "CheatState.h"
+#include "FrameStats.h"
+#include "GameWindow.h"
+#include "HashBenchmark.h"
+#include "Input.h"
+#include "ScreenBuffer.h"
+#include "Terrain.h"
+#include "World.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// ============================================================================
+//  Render Pass Benchmark: World::get_block vs Cursor vs copy_region
+// ============================================================================
+//
+//  Renders the 100x28 viewport while walking east and reports chunk map
+//  probes and time per frame:
+//
+//  1. direct — one get_block per cell plus four per ore (exposure test)
+//  2. cursor — World::Cursor seek + neighbour peeks
+//  3. region — GameWindow::render: one copy_region into a bordered grid,
+//     then plain array scans (this pass also draws the HUD)
+//
+// ============================================================================
+
+inline void render_terrain_direct(World &world, ScreenBuffer &screen,
+                                  int player_x, int player_y) {
+  int cam_x = player_x - SCREEN_WIDTH / 2;
+  int cam_y = player_y - SCREEN_HEIGHT / 2;
+
+  for (int sy = 0; sy < SCREEN_HEIGHT; ++sy) {
+    for (int sx = 0; sx < SCREEN_WIDTH; ++sx) {
+      int wx = cam_x + sx;
+      int wy = cam_y + sy;
+
+      BlockType block;
+      if (wy < 0) {
+        block = BlockType::AIR;
+      } else if (wy >= CHUNK_SIZE) {
+        block = BlockType::BEDROCK;
+      } else {
+        block = world.get_block(wx, wy);
+      }
+      bool is_ore = (block == BlockType::DIAMOND or
+                     block == BlockType::GOLD or block == BlockType::IRON);
+
+      if (is_ore) {
+        bool exposed = world.get_block(wx, wy + 1) == BlockType::AIR or
+                       world.get_block(wx + 1, wy) == BlockType::AIR or
+                       world.get_block(wx - 1, wy) == BlockType::AIR or
+                       world.get_block(wx, wy - 1) == BlockType::AIR;
+        screen.set_pixel(sx, sy,
+                         block_to_pixel(exposed ? block : BlockType::STONE));
+      } else {
+        screen.set_pixel(sx, sy, block_to_pixel(block));
+      }
+    }
+  }
+}
+
+inline void render_terrain_cursor(World &world, ScreenBuffer &screen,
+                                  int player_x, int player_y) {
+  int cam_x = player_x - SCREEN_WIDTH / 2;
+  int cam_y = player_y - SCREEN_HEIGHT / 2;
+  World::Cursor cur(world);
+
+  for (int sy = 0; sy < SCREEN_HEIGHT; ++sy) {
+    for (int sx = 0; sx < SCREEN_WIDTH; ++sx) {
+      int wx = cam_x + sx;
+      int wy = cam_y + sy;
+
+      BlockType block;
+      if (wy < 0) {
+        block = BlockType::AIR;
+      } else if (wy >= CHUNK_SIZE) {
+        block = BlockType::BEDROCK;
+      } else {
+        cur.seek(wx, wy);
+        block = cur.get();
+      }
+      bool is_ore = (block == BlockType::DIAMOND or
+                     block == BlockType::GOLD or block == BlockType::IRON);
+
+      if (is_ore) {
+        bool exposed = cur.down() == BlockType::AIR or
+                       cur.right() == BlockType::AIR or
+                       cur.left() == BlockType::AIR or
+                       cur.up() == BlockType::AIR;
+        screen.set_pixel(sx, sy,
+                         block_to_pixel(exposed ? block : BlockType::STONE));
+      } else {
+        screen.set_pixel(sx, sy, block_to_pixel(block));
+      }
+    }
+  }
+}
+
+inline void run_render_benchmark() {
+  const int NUM_FRAMES = 2000;
+  const int WALK_RANGE = 400;
+
+  World world;
+  CheatState cheats;
+  int player_x = 0;
+  int player_y = CHUNK_SIZE / 2;
+  int facing = 1;
+  int inventory[9] = {0};
+  int selected_block = 1;
+  GameWindow game(world, player_x, player_y, facing, inventory,
+                  selected_block, cheats);
+  ScreenBuffer screen;
+
+  std::cout << "\n========================================\n";
+  std::cout << "   RENDER PASS BENCHMARK\n";
+  std::cout << "   get_block vs Cursor vs copy_region\n";
+  std::cout << "   " << NUM_FRAMES << " frames, " << SCREEN_WIDTH << "x"
+            << SCREEN_HEIGHT << " viewport\n";
+  std::cout << "========================================\n\n";
+
+  // Generate every chunk the walk touches so neither pass pays for terrain
+  for (player_x = 0; player_x < WALK_RANGE; player_x += CHUNK_SIZE) {
+    render_terrain_direct(world, screen, player_x, player_y);
+  }
+
+  world.reset_lookup_count();
+  auto t1 = std::chrono::high_resolution_clock::now();
+  for (int f = 0; f < NUM_FRAMES; ++f) {
+    player_x = f % WALK_RANGE;
+    render_terrain_direct(world, screen, player_x, player_y);
+  }
+  auto t2 = std::chrono::high_resolution_clock::now();
+  auto direct_us =
+      std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count();
+  size_t direct_probes = world.lookup_count();
+
+  world.reset_lookup_count();
+  t1 = std::chrono::high_resolution_clock::now();
+  for (int f = 0; f < NUM_FRAMES; ++f) {
+    player_x = f % WALK_RANGE;
+    render_terrain_cursor(world, screen, player_x, player_y);
+  }
+  t2 = std::chrono::high_resolution_clock::now();
+  auto cursor_us =
+      std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count();
+  size_t cursor_probes = world.lookup_count();
+
+  world.reset_lookup_count();
+  t1 = std::chrono::high_resolution_clock::now();
+  for (int f = 0; f < NUM_FRAMES; ++f) {
+    player_x = f % WALK_RANGE;
+    game.render(screen);
+  }
+  t2 = std::chrono::high_resolution_clock::now();
+  auto region_us =
+      std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count();
+  size_t region_probes = world.lookup_count();
+
+  std::cout << "--- get_block per cell ---\n";
+  std::cout << "  Probes/frame:  " << direct_probes / NUM_FRAMES << "\n";
+  std::cout << "  Time/frame:    "
+            << static_cast<double>(direct_us) / NUM_FRAMES << " us\n\n";
+
+  std::cout << "--- World::Cursor ---\n";
+  std::cout << "  Probes/frame:  " << cursor_probes / NUM_FRAMES << "\n";
+  std::cout << "  Time/frame:    "
+            << static_cast<double>(cursor_us) / NUM_FRAMES << " us\n\n";
+
+  std::cout << "--- copy_region (GameWindow::render, incl. HUD) ---\n";
+  std::cout << "  Probes/frame:  " << region_probes / NUM_FRAMES << "\n";
+  std::cout << "  Time/frame:    "
+            << static_cast<double>(region_us) / NUM_FRAMES << " us\n\n";
+
+  std::cout << "========================================\n";
+  std::cout << "   SUMMARY (vs get_block per cell)\n";
+  std::cout << "   Cursor speedup:      "
+            << static_cast<double>(direct_us) / static_cast<double>(cursor_us)
+            << "x\n";
+  std::cout << "   copy_region speedup: "
+            << static_cast<double>(direct_us) / static_cast<double>(region_us)
+            << "x\n";
+  std::cout << "   Probes/frame:        " << direct_probes / NUM_FRAMES
+            << " -> " << cursor_probes / NUM_FRAMES << " -> "
+            << region_probes / NUM_FRAMES << "\n";
+  std::cout << "========================================\n\n";
+}
+
+// ============================================================================
+//  Residency Benchmark: bounded World with LRU eviction to disk
+// ============================================================================
+//
+//  Walks the player far east (mining a block every few steps so chunks get
+//  modified), then back west over the same ground so spilled chunks fault
+//  back in. Each step copies the viewport like a render frame. Reports the
+//  resident set, eviction/spill/fault counts and worst-case step time.
+//
+// ============================================================================
+
+inline void run_residency_benchmark() {
+  const size_t CAP = 256;
+  const int WALK = 600 * CHUNK_SIZE;
+  const int PIN_RADIUS = 60 + CHUNK_SIZE;
+  const int VIEW_W = SCREEN_WIDTH + 2;
+  const int VIEW_H = CHUNK_SIZE; // rows copied per step
+
+  std::cout << "\n========================================\n";
+  std::cout << "   RESIDENCY BENCHMARK\n";
+  std::cout << "   cap " << CAP << " chunks, walk " << WALK
+            << " blocks east and back\n";
+  std::cout << "========================================\n\n";
+
+  static BlockType view[VIEW_W * VIEW_H];
+
+  auto walk = [&](World &world, long long &max_step_us, size_t &max_resident,
+                  bool dig) {
+    auto step = [&](int x) {
+      auto t1 = std::chrono::high_resolution_clock::now();
+      world.set_pin_area(x, CHUNK_SIZE / 2, PIN_RADIUS);
+      world.copy_region(x - VIEW_W / 2, 0, VIEW_W, VIEW_H, view);
+      if (dig && x % 7 == 0)
+        world.set_block(x, CHUNK_SIZE - 8, BlockType::AIR);
+      auto t2 = std::chrono::high_resolution_clock::now();
+      long long us =
+          std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1)
+              .count();
+      max_step_us = std::max(max_step_us, us);
+      max_resident = std::max(max_resident, world.chunk_count());
+    };
+    for (int x = 0; x < WALK; ++x)
+      step(x);
+    for (int x = WALK - 1; x >= 0; --x)
+      step(x);
+  };
+
+  long long free_max_us = 0;
+  size_t free_max_res = 0;
+  size_t free_bytes = 0;
+  auto t1 = std::chrono::high_resolution_clock::now();
+  {
+    World world;
+    walk(world, free_max_us, free_max_res, true);
+    free_bytes = world.pool_bytes();
+  }
+  auto t2 = std::chrono::high_resolution_clock::now();
+  auto free_us =
+      std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count();
+
+  long long cap_max_us = 0;
+  size_t cap_max_res = 0;
+  World world;
+  world.set_max_resident(CAP);
+  t1 = std::chrono::high_resolution_clock::now();
+  walk(world, cap_max_us, cap_max_res, true);
+  t2 = std::chrono::high_resolution_clock::now();
+  auto cap_us =
+      std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count();
+
+  std::cout << "--- Unbounded ---\n";
+  std::cout << "  Peak resident: " << free_max_res << " chunks\n";
+  std::cout << "  Pool memory:   " << free_bytes / 1024 << " KB\n";
+  std::cout << "  Total time:    " << free_us << " us\n";
+  std::cout << "  Worst step:    " << free_max_us << " us\n\n";
+
+  std::cout << "--- Capped at " << CAP << " ---\n";
+  std::cout << "  Peak resident: " << cap_max_res << " chunks\n";
+  std::cout << "  Pool memory:   " << world.pool_bytes() / 1024 << " KB\n";
+  std::cout << "  Evictions:     " << world.eviction_count() << "\n";
+  std::cout << "  Spill writes:  " << world.spill_write_count() << "\n";
+  std::cout << "  Fault-ins:     " << world.fault_count() << "\n";
+  std::cout << "  Total time:    " << cap_us << " us\n";
+  std::cout << "  Worst step:    " << cap_max_us << " us\n\n";
+
+  std::cout << "========================================\n";
+  std::cout << "   SUMMARY\n";
+  std::cout << "   Memory:              " << free_bytes / 1024 << " KB -> "
+            << world.pool_bytes() / 1024 << " KB\n";
+  std::cout << "   Worst step vs frame: " << cap_max_us << " us / 16000 us\n";
+  std::cout << "========================================\n\n";
+}
+
+// ============================================================================
+//  Sprint Benchmark: synchronous vs background chunk generation
+// ============================================================================
+//
+//  Drives GameWindow through a speed_boost sprint east into fresh terrain
+//  (spectator mode, so nothing blocks the run). Each frame times
+//  handle_input + render, then sleeps FRAME_GAP_MS as a stand-in for the
+//  rest of the frame. Synchronous generation shows up as spikes whenever
+//  the camera enters a new chunk; with prefetch the worker stays ahead.
+//
+// ============================================================================
+
+inline void run_prefetch_benchmark() {
+  const int NUM_FRAMES = 600;
+  const int FRAME_GAP_MS = 1;
+
+  std::cout << "\n========================================\n";
+  std::cout << "   SPRINT BENCHMARK\n";
+  std::cout << "   sync generation vs background prefetch\n";
+  std::cout << "   " << NUM_FRAMES << " frames with speed_boost\n";
+  std::cout << "========================================\n\n";
+
+  struct Result {
+    float avg_us, p99_us, max_us;
+    size_t spikes;
+  };
+
+  auto sprint = [&](bool async) {
+    World world;
+    if (async)
+      world.enable_async_generation();
+    CheatState cheats;
+    cheats.spectator_mode = true;
+    cheats.speed_boost = true;
+    cheats.god_mode = true;
+    int player_x = 0;
+    int player_y = 8;
+    int facing = 1;
+    int inventory[9] = {0};
+    int selected_block = 1;
+    GameWindow game(world, player_x, player_y, facing, inventory,
+                    selected_block, cheats);
+    ScreenBuffer screen;
+    InputState input;
+    input.move_right = true;
+
+    std::vector<float> frame_us;
+    frame_us.reserve(NUM_FRAMES);
+    for (int f = 0; f < NUM_FRAMES; ++f) {
+      game.set_dt(static_cast<float>(FRAME_GAP_MS));
+      auto t1 = std::chrono::high_resolution_clock::now();
+      game.handle_input(input);
+      game.render(screen);
+      auto t2 = std::chrono::high_resolution_clock::now();
+      frame_us.push_back(
+          std::chrono::duration<float, std::micro>(t2 - t1).count());
+      std::this_thread::sleep_for(std::chrono::milliseconds(FRAME_GAP_MS));
+    }
+
+    Result r{};
+    float sum = 0.0f;
+    for (float us : frame_us) {
+      sum += us;
+      if (us > 200.0f)
+        ++r.spikes;
+    }
+    r.avg_us = sum / static_cast<float>(frame_us.size());
+    std::sort(frame_us.begin(), frame_us.end());
+    r.p99_us = frame_us[frame_us.size() * 99 / 100];
+    r.max_us = frame_us.back();
+    return r;
+  };
+
+  Result sync = sprint(false);
+  Result async = sprint(true);
+
+  auto print = [](const char *label, const Result &r) {
+    std::cout << "--- " << label << " ---\n";
+    std::cout << "  Avg frame:     " << r.avg_us << " us\n";
+    std::cout << "  p99 frame:     " << r.p99_us << " us\n";
+    std::cout << "  Worst frame:   " << r.max_us << " us\n";
+    std::cout << "  Frames >200us: " << r.spikes << "\n\n";
+  };
+  print("Synchronous generation", sync);
+  print("Background prefetch", async);
+
+  std::cout << "========================================\n";
+  std::cout << "   SUMMARY\n";
+  std::cout << "   Worst frame:         " << sync.max_us << " us -> "
+            << async.max_us << " us\n";
+  std::cout << "   Spike frames:        " << sync.spikes << " -> "
+            << async.spikes << "\n";
+  std::cout << "========================================\n\n";
+}
+
+// ============================================================================
+//  Uniform Chunk Benchmark: spectator flight through sky and bedrock
+// ============================================================================
+//
+//  Flies the viewport diagonally from high above the terrain row to deep
+//  below it. Every chunk the view touches used to be generated and pooled;
+//  now only terrain-row chunks are, and sky/bedrock chunks resolve to the
+//  two shared uniform chunks.
+//
+// ============================================================================
+
+inline void run_uniform_chunk_benchmark() {
+  const int DEPTH = 200 * CHUNK_SIZE; // blocks above and below the terrain
+  const int VIEW_W = SCREEN_WIDTH + 2;
+  const int VIEW_H = SCREEN_HEIGHT + 2;
+
+  std::cout << "\n========================================\n";
+  std::cout << "   UNIFORM CHUNK BENCHMARK\n";
+  std::cout << "   spectator flight, y " << -DEPTH << " -> " << DEPTH
+            << "\n";
+  std::cout << "========================================\n\n";
+
+  static BlockType view[VIEW_W * VIEW_H];
+  World world;
+  RobinHoodMap<Coord, bool, CoordHash> touched;
+  auto chunk_of = [](int v) {
+    return v >= 0 ? v / CHUNK_SIZE : (v - CHUNK_SIZE + 1) / CHUNK_SIZE;
+  };
+
+  long long max_step_us = 0;
+  auto t1 = std::chrono::high_resolution_clock::now();
+  for (int y = -DEPTH; y < DEPTH; ++y) {
+    int x = y / 2;
+    auto s1 = std::chrono::high_resolution_clock::now();
+    world.copy_region(x, y, VIEW_W, VIEW_H, view);
+    auto s2 = std::chrono::high_resolution_clock::now();
+    max_step_us = std::max<long long>(
+        max_step_us,
+        std::chrono::duration_cast<std::chrono::microseconds>(s2 - s1)
+            .count());
+    for (int cy = chunk_of(y); cy <= chunk_of(y + VIEW_H - 1); ++cy) {
+      for (int cx = chunk_of(x); cx <= chunk_of(x + VIEW_W - 1); ++cx) {
+        touched[{cx, cy}] = true;
+      }
+    }
+  }
+  auto t2 = std::chrono::high_resolution_clock::now();
+  auto total_us =
+      std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count();
+
+  size_t before_bytes = touched.size() * ChunkPool::SLOT_BYTES;
+  std::cout << "  Chunks touched:  " << touched.size() << "\n";
+  std::cout << "  Chunks stored:   " << world.chunk_count() << "\n";
+  std::cout << "  Pool memory:     " << world.pool_bytes() / 1024
+            << " KB (one chunk each: " << before_bytes / 1024 << " KB)\n";
+  std::cout << "  Total time:      " << total_us << " us\n";
+  std::cout << "  Worst step:      " << max_step_us << " us\n\n";
+
+  std::cout << "========================================\n";
+  std::cout << "   SUMMARY\n";
+  std::cout << "   Stored chunks: " << touched.size() << " -> "
+            << world.chunk_count() << "\n";
+  std::cout << "========================================\n\n";
+}
+
+// ============================================================================
+//  Chunk Map Telemetry: RobinHoodMap behaviour on live chunk keys
+// ============================================================================
+//
+//  The residency walk (cap 256, pinned view, digging) drives the World's
+//  chunk index through real inserts, lookups and evictions, then prints
+//  what the map saw. Counters need -DROBINHOOD_STATS; the PSL snapshot
+//  is always there.
+//
+// ============================================================================
+
+inline void run_chunk_map_telemetry_report() {
+  const size_t CAP = 256;
+  const int WALK = 300 * CHUNK_SIZE;
+  const int PIN_RADIUS = 60 + CHUNK_SIZE;
+  const int VIEW_W = SCREEN_WIDTH + 2;
+
+  std::cout << "\n========================================\n";
+  std::cout << "   CHUNK MAP TELEMETRY\n";
+  std::cout << "   World::chunks over a capped walk, " << WALK
+            << " blocks east and back\n";
+  std::cout << "========================================\n\n";
+
+  static BlockType view[VIEW_W * CHUNK_SIZE];
+  World world;
+  world.set_max_resident(CAP);
+  auto step = [&](int x) {
+    world.set_pin_area(x, CHUNK_SIZE / 2, PIN_RADIUS);
+    world.copy_region(x - VIEW_W / 2, 0, VIEW_W, CHUNK_SIZE, view);
+    if (x % 7 == 0)
+      world.set_block(x, CHUNK_SIZE - 8, BlockType::AIR);
+  };
+  for (int x = 0; x < WALK; ++x)
+    step(x);
+  for (int x = WALK - 1; x >= 0; --x)
+    step(x);
+
+  std::cout << "  Evictions: " << world.eviction_count() << "\n";
+  print_map_stats("World::chunks", world.chunk_map());
+}
@@ -1,22 +1,32 @@
+#include "AStar.h"
 #include "Benchmark.h"
 #include "BloomBenchmark.h"
 #include "BlockType.h"
 #include "CheatState.h"
 #include "CheatWindow.h"
 #include "Chunk.h"
+#include "ChunkBenchmark.h"
+#include "ConcurrentRobinHoodMap.h"
 #include "Coord.h"
 #include "FastRand.h"
+#include "FlowField.h"
 #include "GameWindow.h"
 #include "HashBenchmark.h"
 #include "Input.h"
 #include "InventoryWindow.h"
+#include "MobPaths.h"
+#include "PathBenchmark.h"
+#include "PathContext.h"
 #include "PauseWindow.h"
 #include "Pixel.h"
+#include "PortalGraph.h"
 #include "SaveLoad.h"
 #include "TitleWindow.h"
 #include "RobinHoodMap.h"
+#include "RobinHoodSet.h"
 #include "ScreenBuffer.h"
 #include "World.h"
+#include "WorldBenchmark.h"
 #include <cassert>
 #include <cmath>
 #include <cstdlib>
@@ -24,10 +34,16 @@
 #include <ctime>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <optional>
 #include <sstream>
 #include <stack>
+#include <stdexcept>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 // THIS enables colored output on Windows terminal
 #ifdef _WIN32
@@ -251,6 +267,56 @@ void test_chunk() {
   assert(chunk.get_block(5, 7) == BlockType::AIR);
   cout << "Mining: correct\n";
 
+  // 7. Packed storage — half the bytes of a 1 byte/block array
+  assert(sizeof(PackedBlocks) < sizeof(BlockType) * CHUNK_SIZE * CHUNK_SIZE);
+  assert(chunk.get_packed().index_bits() == 4);
+  auto unpacked = chunk_copy.get_blocks();
+  Chunk repacked({0, 0}, unpacked);
+  for (int y = 0; y < CHUNK_SIZE; y++) {
+    for (int x = 0; x < CHUNK_SIZE; x++) {
+      assert(repacked.get_block(x, y) == chunk_copy.get_block(x, y));
+    }
+  }
+  cout << "Packed storage: " << sizeof(PackedBlocks)
+       << " bytes, round-trip correct\n";
+
+  // 8. Palette widens to 8 bits past 16 distinct types
+  PackedBlocks wide;
+  for (int i = 0; i < 40; i++) {
+    wide.set(i, static_cast<BlockType>(i));
+  }
+  assert(wide.index_bits() == 8);
+  for (int i = 0; i < 40; i++) {
+    assert(wide.get(i) == static_cast<BlockType>(i));
+  }
+  assert(wide.get(PackedBlocks::CELLS - 1) == BlockType::AIR);
+  cout << "Palette widening: correct\n";
+
+  // 8b. 4-bit data under a per-chunk palette (older saves) is re-coded
+  BlockType old_pal[2] = {BlockType::STONE, BlockType::AIR};
+  uint8_t old_idx[PackedBlocks::CELLS / 2] = {0x10}; // cell 1 AIR, rest STONE
+  PackedBlocks recoded;
+  assert(recoded.load_packed(4, old_pal, 2, old_idx));
+  assert(recoded.index_bits() == 4);
+  assert(recoded.get(0) == BlockType::STONE);
+  assert(recoded.get(1) == BlockType::AIR);
+  assert(recoded.get(PackedBlocks::CELLS - 1) == BlockType::STONE);
+  cout << "Old palette re-coding: correct\n";
+
+  // 9. Solidity bits track generation and edits
+  Chunk solid({4, 0});
+  for (int y = 0; y < CHUNK_SIZE; y++) {
+    for (int x = 0; x < CHUNK_SIZE; x++) {
+      assert(solid.is_air(x, y) == (solid.get_block(x, y) == BlockType::AIR));
+    }
+  }
+  assert(solid.solid_row(CHUNK_SIZE - 1) == 0xFFFFFFFFu); // bedrock
+  solid.set_block(3, 0, BlockType::STONE);
+  solid.set_block(3, CHUNK_SIZE - 1, BlockType::AIR);
+  assert(!solid.is_air(3, 0) && solid.is_air(3, CHUNK_SIZE - 1));
+  assert((solid.solid_column(3) & 1u) && !(solid.solid_column(3) >> 31));
+  cout << "Solidity bitset: in sync with blocks\n";
+
   cout << "All Chunk tests PASSED!\n";
 }
 
@@ -325,9 +391,10 @@ void test_world() {
   assert(world.chunk_count() == 2);
   cout << "Different chunk: " << world.chunk_count() << " chunks now\n";
 
-  // 5. Negative coordinates work
-  world.get_block(-5, -15);
-  assert(world.chunk_count() == 3);
+  // 5. Negative coordinates work — chunk (-1, -1) is open sky, served by
+  // the shared uniform chunk rather than stored
+  assert(world.get_block(-5, -15) == BlockType::AIR);
+  assert(world.chunk_count() == 2);
   cout << "Negative coords: " << world.chunk_count() << " chunks\n";
 
   // 6. Mining in world coordinates
@@ -335,7 +402,491 @@ void test_world() {
   assert(world.get_block(25, 7) == BlockType::AIR);
   cout << "Mining at (25,7): correct\n";
 
-  // 7. Print a slice of the world (3 chunks wide)
+  // 7. Cursor — cached chunk, lookups only when leaving it
+  World::Cursor cur(world);
+  world.reset_lookup_count();
+  for (int x = 64; x < 96; x++) {
+    for (int y = 0; y < CHUNK_SIZE; y++) {
+      assert(cur.get_block(x, y) == world.get_chunk({2, 0}).get_block(x - 64, y));
+    }
+  }
+  assert(world.lookup_count() == 1 + 32 * 32);
+  world.reset_lookup_count();
+  cur.seek(64, 10); // left edge of chunk (2, 0)
+  assert(cur.left() == world.get_block(63, 10));
+  assert(cur.right() == world.get_block(65, 10));
+  cur.set_block(-1, -1, BlockType::GOLD);
+  assert(world.get_block(-1, -1) == BlockType::GOLD);
+  cout << "Cursor: cached access + border neighbours correct\n";
+
+  // 8. copy_region — rectangle spanning four chunks
+  const int RW = 40, RH = 20;
+  BlockType region[RW * RH];
+  world.copy_region(-20, -10, RW, RH, region);
+  for (int y = 0; y < RH; y++) {
+    for (int x = 0; x < RW; x++) {
+      assert(region[y * RW + x] == world.get_block(x - 20, y - 10));
+    }
+  }
+  cout << "copy_region: matches get_block across chunk borders\n";
+
+  // 9. Pooled chunks — references stay valid, clear() recycles memory
+  Chunk &kept = world.get_chunk({2, 0});
+  for (int i = 0; i < 500; i++) {
+    world.get_chunk({100 + i, 0});
+  }
+  assert(&kept == &world.get_chunk({2, 0}));
+  size_t pool_before = world.pool_bytes();
+  world.clear();
+  assert(world.chunk_count() == 0);
+  for (int i = 0; i < 500; i++) {
+    world.get_chunk({100 + i, 0});
+  }
+  assert(world.pool_bytes() == pool_before);
+  world.load_chunk({100, 0}, PackedBlocks());
+  assert(world.get_block(100 * CHUNK_SIZE, CHUNK_SIZE - 1) == BlockType::AIR);
+  cout << "Chunk pool: stable references, reuse after clear()\n";
+
+  // 10. Residency cap — LRU eviction, modified chunks spill and fault back
+  World capped;
+  capped.set_max_resident(8);
+  capped.set_pin_area(0, 0, 0);
+  capped.set_block(5, 5, BlockType::DIAMOND);   // chunk (0, 0), pinned
+  capped.set_block(100, 5, BlockType::DIAMOND); // chunk (3, 0)
+  for (int i = 0; i < 40; i++) {
+    capped.get_block((10 + i) * CHUNK_SIZE, 0);
+  }
+  assert(capped.chunk_count() <= 8);
+  assert(capped.spilled_count() == 1);
+  assert(capped.get_block(5, 5) == BlockType::DIAMOND);
+  assert(capped.get_block(100, 5) == BlockType::DIAMOND);
+  assert(capped.fault_count() == 1 && capped.spilled_count() == 0);
+  // Every World spills to its own file: a second one can't truncate ours
+  World neighbour;
+  neighbour.set_max_resident(8);
+  neighbour.set_block(100, 5, BlockType::GOLD);
+  capped.set_block(100, 6, BlockType::IRON);
+  for (int i = 0; i < 40; i++) {
+    capped.get_block((10 + i) * CHUNK_SIZE, 0);
+    neighbour.get_block((10 + i) * CHUNK_SIZE, 0);
+  }
+  assert(capped.spilled_count() == 1 && neighbour.spilled_count() == 1);
+  assert(capped.get_block(100, 6) == BlockType::IRON);
+  assert(neighbour.get_block(100, 5) == BlockType::GOLD);
+  cout << "Residency cap: " << capped.eviction_count()
+       << " evictions, spill + fault-in correct, one spill file per World\n";
+
+  // 11. Background generation — not ready first, identical terrain after
+  World async_world;
+  async_world.enable_async_generation();
+  assert(async_world.get_chunk_if_ready({7, 0}) == nullptr);
+  assert(async_world.pending_count() == 1);
+  while (async_world.pump_generated() == 0) {
+    std::this_thread::yield();
+  }
+  Chunk *ready = async_world.get_chunk_if_ready({7, 0});
+  assert(ready != nullptr && async_world.pending_count() == 0);
+  for (int y = 0; y < CHUNK_SIZE; y++) {
+    for (int x = 0; x < CHUNK_SIZE; x++) {
+      assert(ready->get_block(x, y) == world.get_chunk({7, 0}).get_block(x, y));
+    }
+  }
+  cout << "Async generation: pending -> installed, terrain identical\n";
+
+  // 12. Uniform chunks — shared until the first write copies them
+  World tall;
+  World::Cursor sky_cur(tall);
+  for (int cy = 1; cy <= 100; cy++) {
+    assert(tall.get_block(0, -cy * CHUNK_SIZE) == BlockType::AIR);
+    assert(tall.get_block(0, cy * CHUNK_SIZE) == BlockType::BEDROCK);
+  }
+  assert(&tall.get_chunk({0, -1}) == &tall.get_chunk({5, -9}));
+  assert(tall.get_chunk({3, 4}).is_shared());
+  assert(tall.chunk_count() == 0 && tall.pool_bytes() == 0);
+  assert(sky_cur.get_block(3, -40) == BlockType::AIR); // caches shared chunk
+  tall.set_block(3, -40, BlockType::WOOD);
+  assert(tall.chunk_count() == 1 && !tall.get_chunk({0, -2}).is_shared());
+  assert(sky_cur.get_block(3, -40) == BlockType::WOOD);
+  assert(tall.get_block(3, -8) == BlockType::AIR); // neighbour still shared
+  sky_cur.set_block(40, 70, BlockType::AIR);
+  assert(tall.get_block(40, 70) == BlockType::AIR);
+  assert(tall.get_block(41, 70) == BlockType::BEDROCK);
+  assert(tall.chunk_count() == 2);
+  // loading over a shared chunk drops it from the cursor too
+  assert(sky_cur.get_block(3, -168) == BlockType::AIR);
+  tall.load_chunk({0, -6}, tall.get_chunk({0, -2}).get_packed());
+  assert(sky_cur.get_block(3, -168) == BlockType::WOOD);
+  cout << "Uniform chunks: 200 shared, copy-on-write on first edit\n";
+
+  // 13. Non-generating probes — "not loaded" instead of a new chunk
+  World probe;
+  assert(!probe.try_get_block(10, 10).has_value());
+  assert(probe.try_get_block(10, -10) == BlockType::AIR); // shared sky
+  assert(bfs_findpath({10, 5}, {40, 5}, probe, 150).empty());
+  assert(probe.chunk_count() == 0);
+  probe.set_generation_budget(1);
+  probe.begin_frame();
+  assert(probe.try_get_block(10, 10, World::Generate::WITHIN_BUDGET));
+  assert(!probe.try_get_block(40, 10, World::Generate::WITHIN_BUDGET));
+  assert(probe.chunk_count() == 1 && probe.budget_refusal_count() == 1);
+  probe.begin_frame();
+  assert(probe.try_get_block(40, 10, World::Generate::WITHIN_BUDGET));
+  assert(probe.try_get_block(40, 10) == probe.get_block(40, 10));
+  cout << "Probes: no generation, budget of 1 chunk per frame honoured\n";
+  for (int x = 32; x < 64; x++) {
+    int ground = *probe.try_first_solid_below(x, -40, CHUNK_SIZE - 1);
+    int y = -40;
+    while (probe.get_block(x, y) == BlockType::AIR) {
+      y++;
+    }
+    assert(ground == y && !probe.is_air(x, y));
+  }
+  assert(!probe.try_first_solid_below(200, 0, 10).has_value());
+  cout << "Column scan: matches a get_block walk\n";
+
+  // 14. FlowField — same distances as a per-mob bfs_search, and each step
+  // is a legal move one closer. Ground with a pit and a 1-block ledge.
+  auto field_air = [](int x, int y) {
+    int ground = (x >= 10 && x < 14) ? 24 : (x >= 20 ? 19 : 20);
+    return y < ground;
+  };
+  FlowField field;
+  Coord field_target = {0, 19};
+  field.build(field_target, field_air, 40);
+  assert(field.distance(field_target) == 0);
+  assert(!field.next_step(field_target).has_value());
+  for (int x = -30; x <= 35; ++x) {
+    for (int y = 10; y < 24; ++y) {
+      if (!field_air(x, y))
+        continue;
+      Coord m = {x, y};
+      std::vector<Coord> path = bfs_search(m, field_target, field_air, 150);
+      int len = path.empty() ? -1 : static_cast<int>(path.size()) - 1;
+      assert(field.distance(m) == len);
+      if (std::optional<Coord> next = field.next_step(m)) {
+        assert(can_step(m, *next - m, field_air));
+        assert(field.distance(*next) == len - 1);
+      }
+    }
+  }
+  assert(field.distance({100, 19}) == -1); // outside the window
+  size_t field_reached = field.reached_count();
+  field.build({30, 18}, field_air, 40); // resets only what it touched
+  assert(field.distance(field_target) ==
+         static_cast<int>(bfs_search(field_target, {30, 18}, field_air, 150)
+                              .size()) -
+             1);
+  field.build(field_target, field_air, 40);
+  assert(field.reached_count() == field_reached);
+  assert(field.distance({12, 23}) ==
+         static_cast<int>(bfs_search({12, 23}, field_target, field_air, 150)
+                              .size()) -
+             1);
+  cout << "Flow field: matches per-mob BFS distances ("
+       << field.reached_count() << " cells reached)\n";
+
+  // 15. PathContext — node-for-node the same search as bfs_search, reused
+  // across starts and depths, including a shallow search after a deep one
+  PathContext path_ctx;
+  vector<Coord> ctx_path;
+  Coord ctx_starts[] = {{0, 19}, {-25, 19}, {12, 23}, {30, 18}};
+  for (Coord from : ctx_starts) {
+    for (Coord to : ctx_starts) {
+      for (int depth : {150, 5, 40}) {
+        size_t ctx_expanded = 0, bfs_expanded = 0;
+        bool ok = path_ctx.search(from, to, field_air, depth, ctx_path,
+                                  &ctx_expanded);
+        vector<Coord> expect =
+            bfs_search(from, to, field_air, depth, &bfs_expanded);
+        assert(ok == !expect.empty() && ctx_path == expect);
+        assert(ctx_expanded == bfs_expanded);
+      }
+    }
+  }
+  size_t ctx_bytes = path_ctx.reserved_bytes();
+  path_ctx.search({0, 19}, {30, 18}, field_air, 80, ctx_path);
+  assert(path_ctx.reserved_bytes() == ctx_bytes); // warm: nothing new
+  cout << "PathContext: matches bfs_search, " << ctx_bytes / 1024
+       << " KB reused\n";
+
+  // 16. Reachability index — never rules out a path bfs_search finds; a
+  // walled-in cell is unreachable until a wall is mined, which relabels
+  // only the chunk it is in
+  World rw;
+  for (int cx = 0; cx < 4; ++cx) {
+    rw.get_chunk({cx, 0});
+  }
+  World::Cursor reach_cur(rw);
+  auto reach_air = [&](int x, int y) {
+    return reach_cur.try_is_air(x, y) == true;
+  };
+  vector<Coord> reach_cells;
+  for (int x = 3; x < 4 * CHUNK_SIZE; x += 11) {
+    for (int y = 1; y < CHUNK_SIZE; y += 4) {
+      if (rw.is_air(x, y))
+        reach_cells.push_back({x, y});
+    }
+  }
+  size_t ruled_out = 0;
+  for (size_t i = 0; i < reach_cells.size(); ++i) {
+    Coord to = reach_cells[(i * 7) % reach_cells.size()];
+    bool maybe = rw.may_reach(reach_cells[i], to);
+    assert(maybe || bfs_search(reach_cells[i], to, reach_air, 150).empty());
+    ruled_out += !maybe;
+  }
+  auto surface_at = [&](int x) {
+    int y = 0;
+    while (rw.is_air(x, y + 1))
+      ++y;
+    return Coord{x, y};
+  };
+  Coord shelter = surface_at(40);
+  Coord outside = surface_at(100);
+  for (int y = shelter.y - 1; y <= shelter.y + 1; ++y) {
+    for (int x = shelter.x - 1; x <= shelter.x + 1; ++x) {
+      if (Coord{x, y} != shelter)
+        rw.set_block(x, y, BlockType::STONE);
+    }
+  }
+  assert(!rw.may_reach(outside, shelter) && !rw.may_reach(shelter, outside));
+  assert(bfs_findpath(outside, shelter, rw, 150).empty());
+  size_t relabels = rw.reachability().relabel_count();
+  rw.set_block(shelter.x, shelter.y - 1, BlockType::AIR); // open the roof
+  assert(rw.may_reach(outside, shelter));
+  assert(rw.reachability().relabel_count() == relabels + 1);
+  assert(rw.reachability().increment_count() > 0);
+
+  // Incremental updates answer exactly as an index built from scratch,
+  // through edits on chunk borders, a chunk arriving and one evicted
+  World iw;
+  for (int cx = 0; cx < 3; ++cx)
+    iw.get_chunk({cx, 0});
+  auto iw_sky = [&](Coord cp) {
+    Chunk *c = iw.try_get_chunk(cp);
+    return c && c->is_shared() && c->is_air(0, 0);
+  };
+  auto agrees_with_fresh = [&] {
+    ReachabilityIndex fresh;
+    fresh.activate();
+    for (auto [pos, c] : iw)
+      fresh.installed(pos, c);
+    World::Cursor iw_cur(iw);
+    vector<Coord> air;
+    for (int x = 1; x < 4 * CHUNK_SIZE; x += 5) {
+      for (int y = 0; y < CHUNK_SIZE; y += 3) {
+        if (iw_cur.try_is_air(x, y) == true)
+          air.push_back({x, y});
+      }
+    }
+    for (size_t i = 0; i < air.size(); ++i) {
+      Coord a = air[i], b = air[(i * 13 + 5) % air.size()];
+      assert(iw.may_reach(a, b) == fresh.may_reach(a, b, iw_sky));
+    }
+  };
+  agrees_with_fresh();
+  std::mt19937 edit_rng(5);
+  for (int e = 0; e < 120; ++e) {
+    int x = (1 + static_cast<int>(edit_rng() % 2)) * CHUNK_SIZE - 3 +
+            static_cast<int>(edit_rng() % 6);
+    int y = static_cast<int>(edit_rng() % CHUNK_SIZE);
+    iw.set_block(x, y, edit_rng() % 2 ? BlockType::AIR : BlockType::STONE);
+    agrees_with_fresh();
+  }
+  iw.get_chunk({3, 0});
+  agrees_with_fresh();
+  iw.set_max_resident(3);
+  agrees_with_fresh();
+  cout << "Reachability: " << ruled_out << "/" << reach_cells.size()
+       << " searches ruled out, shelter sealed then opened, "
+       << iw.reachability().increment_count() << " of "
+       << iw.reachability().increment_count() +
+              iw.reachability().rebuild_count()
+       << " updates incremental\n";
+
+  // 17. PortalGraph — as short as a BFS kept to the loaded chunks and the
+  // sky beside them, every step legal; an edit rebuilds the portals of the
+  // chunks it touches; a hill up to y = 0 is crossed through the sky row.
+  // Trees felled first so surface walks go further.
+  for (int x = 0; x < 4 * CHUNK_SIZE; ++x) {
+    for (int y = 0; y < CHUNK_SIZE; ++y) {
+      BlockType b = rw.get_block(x, y);
+      if (b == BlockType::WOOD || b == BlockType::LEAF)
+        rw.set_block(x, y, BlockType::AIR);
+    }
+  }
+  auto loaded_air = [&](int x, int y) {
+    return x >= -CHUNK_SIZE && x < 5 * CHUNK_SIZE && y >= -CHUNK_SIZE &&
+           y < CHUNK_SIZE && reach_air(x, y);
+  };
+  vector<Coord> stand_cells; // surface, and a cave cell every 9 columns
+  for (int x = 2; x < 4 * CHUNK_SIZE; x += 3) {
+    stand_cells.push_back(surface_at(x));
+    for (int y = stand_cells.back().y + 2; x % 9 == 2 && y < CHUNK_SIZE - 1;
+         ++y) {
+      if (rw.is_air(x, y) && !rw.is_air(x, y + 1)) {
+        stand_cells.push_back({x, y});
+        break;
+      }
+    }
+  }
+  PortalGraph portals;
+  vector<Coord> hpa_path;
+  size_t hpa_found = 0;
+  for (size_t i = 0; i < stand_cells.size(); ++i) {
+    Coord from = stand_cells[i];
+    Coord to = stand_cells[(i * 7) % stand_cells.size()];
+    vector<Coord> expect = bfs_search(from, to, loaded_air, 1000);
+    bool ok = portals.find_path(rw, from, to, hpa_path);
+    assert(ok == !expect.empty() && hpa_path.size() == expect.size());
+    for (size_t k = 1; k < hpa_path.size(); ++k)
+      assert(can_step(hpa_path[k - 1], hpa_path[k] - hpa_path[k - 1],
+                      loaded_air));
+    hpa_found += ok;
+  }
+  Coord far_side = surface_at(4);
+  size_t builds = portals.rebuild_count();
+  rw.set_block(shelter.x, shelter.y - 1, BlockType::STONE); // reseal
+  assert(!portals.find_path(rw, far_side, shelter, hpa_path));
+  assert(portals.rebuild_count() > builds);
+  rw.set_block(shelter.x, shelter.y - 1, BlockType::AIR);
+  assert(portals.find_path(rw, far_side, shelter, hpa_path) ==
+         !bfs_search(far_side, shelter, loaded_air, 1000).empty());
+  const int HILL = 20; // columns HILL..HILL+6 rise to y = 0 and fall again
+  for (int x = HILL; x <= HILL + 6; ++x) {
+    int top = std::abs(x - HILL - 3);
+    for (int y = 0; y < CHUNK_SIZE; ++y)
+      rw.set_block(x, y, y < top ? BlockType::AIR : BlockType::STONE);
+  }
+  assert(portals.find_path(rw, {HILL, 2}, {HILL + 6, 2}, hpa_path));
+  assert(hpa_path.size() ==
+         bfs_search({HILL, 2}, {HILL + 6, 2}, loaded_air, 1000).size());
+  assert(std::any_of(hpa_path.begin(), hpa_path.end(),
+                     [](Coord c) { return c.y < 0; }));
+  cout << "PortalGraph: " << hpa_found << "/" << stand_cells.size()
+       << " paths found, lengths match BFS, "
+       << portals.portal_count() << " portals\n";
+
+  // 18. A* — Chebyshev finds BFS-length paths, weight 2 at most twice as
+  // long, octile some legal path; all over the same moves
+  size_t astar_nodes = 0, bfs_nodes = 0;
+  for (size_t i = 0; i < stand_cells.size(); ++i) {
+    Coord from = stand_cells[i];
+    Coord to = stand_cells[(i * 5 + 3) % stand_cells.size()];
+    size_t a_expanded = 0, b_expanded = 0;
+    vector<Coord> expect = bfs_search(from, to, reach_air, 150, &b_expanded);
+    vector<Coord> exact = astar_search(from, to, reach_air, 150,
+                                       Heuristic::CHEBYSHEV, 1.0f, &a_expanded);
+    assert(exact.size() == expect.size());
+    assert(astar_findpath(from, to, rw, 150).size() == expect.size());
+    astar_nodes += a_expanded;
+    bfs_nodes += b_expanded;
+    vector<Coord> greedy =
+        astar_search(from, to, reach_air, 300, Heuristic::CHEBYSHEV, 2.0f);
+    assert(greedy.empty() == expect.empty());
+    assert(greedy.size() <= 2 * expect.size());
+    vector<Coord> octile =
+        astar_search(from, to, reach_air, 300, Heuristic::OCTILE);
+    assert(octile.empty() == expect.empty());
+    for (const vector<Coord> *p : {&exact, &greedy, &octile}) {
+      for (size_t k = 1; k < p->size(); ++k)
+        assert(can_step((*p)[k - 1], (*p)[k] - (*p)[k - 1], reach_air));
+    }
+  }
+  assert(astar_nodes < bfs_nodes);
+  cout << "A*: BFS-length paths, " << astar_nodes << " nodes expanded vs "
+       << bfs_nodes << " for BFS\n";
+
+  // 19. Move masks — every cell's byte equals can_step over all eight
+  // moves, through edits on and across chunk borders and a chunk arriving
+  // next to the tabled ones; bfs_findpath reading them finds bfs_search's
+  // paths
+  auto masks_match = [&](int x0, int x1) {
+    World::Cursor mask_cur(rw);
+    for (int y = -3; y < CHUNK_SIZE + 3; ++y) {
+      for (int x = x0; x <= x1; ++x) {
+        uint8_t expect = move_mask({x, y}, reach_air);
+        assert(rw.move_mask({x, y}) == expect);
+        assert(mask_cur.moves(x, y) == expect);
+      }
+    }
+  };
+  masks_match(-3, 4 * CHUNK_SIZE + 2);
+  size_t recomputed = rw.move_masks().recompute_count();
+  Coord dug = surface_at(48) + Coord{0, 1}; // ground inside chunk 1
+  rw.set_block(dug.x, dug.y, BlockType::AIR);
+  assert(rw.move_masks().recompute_count() == recomputed + 12);
+  for (int y = 2; y < 12; ++y) { // a wall on the border of chunks 1 and 2
+    rw.set_block(2 * CHUNK_SIZE - 1, y, BlockType::STONE);
+    World::Cursor(rw).set_block(2 * CHUNK_SIZE, y + 3, BlockType::AIR);
+  }
+  masks_match(-3, 4 * CHUNK_SIZE + 2);
+  rw.get_chunk({4, 0}); // the rim of chunk 3 now sees its neighbour
+  masks_match(3 * CHUNK_SIZE - 3, 5 * CHUNK_SIZE + 2);
+  for (size_t i = 0; i < stand_cells.size(); ++i) {
+    Coord from = stand_cells[i];
+    Coord to = stand_cells[(i * 7 + 1) % stand_cells.size()];
+    assert(bfs_findpath(from, to, rw, 150) ==
+           bfs_search(from, to, reach_air, 150));
+  }
+  cout << "Move masks: " << rw.move_masks().chunk_count()
+       << " chunks tabled, match can_step after edits\n";
+
+  // 20. MobPaths — a plan is followed step by step and kept across edits
+  // that leave its moves legal; an edit on the path, the player moving
+  // past the threshold or the mob being pushed off it forces a replan
+  Coord mob_goal = {}, mob_start = {};
+  FlowField mob_field;
+  for (size_t i = 0; i < stand_cells.size() && mob_start == mob_goal; ++i) {
+    build_flow_field(mob_field, stand_cells[i], rw);
+    for (Coord c : stand_cells) {
+      if (mob_field.distance(c) >= 6) {
+        mob_goal = stand_cells[i];
+        mob_start = c;
+        break;
+      }
+    }
+  }
+  assert(mob_start != mob_goal);
+  MobPaths mob_paths;
+  mob_paths.add();
+  mob_paths.add();
+  assert(!mob_paths.reuse(0, mob_start, mob_goal, rw, 3)); // no plan yet
+  mob_paths.plan(0, mob_start, mob_goal, rw.edit_epoch(),
+                 [&](Coord c) { return mob_field.next_move(c); });
+  assert(mob_paths.moves[0].size() ==
+         static_cast<size_t>(mob_field.distance(mob_start)));
+  Coord mob_at = mob_start;
+  for (int k = 0; k < 2; ++k) {
+    assert(mob_paths.reuse(0, mob_at, mob_goal, rw, 3));
+    Coord next = *mob_paths.advance(0);
+    assert(next == *mob_field.next_step(mob_at));
+    mob_at = next;
+  }
+  size_t revalidated = mob_paths.revalidations;
+  rw.set_block(mob_goal.x, CHUNK_SIZE - 3, BlockType::AIR); // deep, off path
+  rw.set_block(mob_goal.x, CHUNK_SIZE - 3, BlockType::STONE);
+  assert(mob_paths.reuse(0, mob_at, mob_goal + Coord{3, 0}, rw, 3));
+  assert(mob_paths.revalidations == revalidated + 1);
+  assert(!mob_paths.reuse(0, mob_at, mob_goal + Coord{4, 0}, rw, 3));
+  assert(!mob_paths.reuse(0, mob_at + Coord{1, 0}, mob_goal, rw, 3));
+  Coord ahead = mob_at + PATH_DIRS[mob_paths.moves[0][mob_paths.next[0]]];
+  BlockType ahead_was = rw.get_block(ahead.x, ahead.y);
+  rw.set_block(ahead.x, ahead.y, BlockType::STONE); // block the next step
+  assert(!mob_paths.reuse(0, mob_at, mob_goal, rw, 3));
+  rw.set_block(ahead.x, ahead.y, ahead_was);
+  mob_paths.remove(0);
+  assert(mob_paths.count() == 1 && mob_paths.epoch[0] == MobPaths::NO_PLAN);
+  mob_paths.plan_path(0, mob_start, mob_goal, rw.edit_epoch(),
+                      bfs_findpath(mob_start, mob_goal, rw, 150));
+  assert(mob_paths.moves[0].size() ==
+         static_cast<size_t>(mob_field.distance(mob_start)));
+  for (mob_at = mob_start; std::optional<Coord> next = mob_paths.advance(0);)
+    mob_at = *next;
+  assert(mob_at == mob_goal);
+  cout << "MobPaths: " << mob_paths.hits << " hits, " << mob_paths.misses
+       << " misses, edits off the path revalidated\n";
+
+  // 21. Print a slice of the world (3 chunks wide)
   cout << "\nWorld view (x: 0-29, y: 0-9):\n";
   print_world(world, 0, 29, 0, 9);
 
@@ -592,6 +1143,313 @@ void test_robinhood() {
   assert((empty_map.erase({0, 0}) == false));
   cout << "Empty map ops: correct\n";
 
+  // 11. Probe lengths — chunk-origin coords (multiples of CHUNK_SIZE) used
+  // to pile onto a few home slots; with the mixed hash they stay short
+  RobinHoodMap<Coord, int, CoordHash> stride_map;
+  for (int y = 0; y < 16; ++y) {
+    for (int x = 0; x < 512; ++x) {
+      stride_map[{x * CHUNK_SIZE, y * CHUNK_SIZE}] = x;
+    }
+  }
+  vector<size_t> hist = stride_map.psl_histogram();
+  size_t hist_total = 0;
+  for (size_t n : hist) {
+    hist_total += n;
+  }
+  assert(hist_total == stride_map.size());
+  assert(hist.size() <= 16);
+  cout << "PSL histogram: max probe length " << hist.size() - 1 << "\n";
+
+  // 12. Long same-home runs — 40 keys per home push probes across 16-slot
+  // control groups and around the end of the table
+  struct CoarseHash {
+    size_t operator()(int k) const { return static_cast<size_t>(k / 40) * 97; }
+  };
+  RobinHoodMap<int, int, CoarseHash> run_map;
+  for (int i = 0; i < 4000; ++i) {
+    run_map[i] = i * 3;
+  }
+  for (int i = 0; i < 4000; i += 2) {
+    assert(run_map.erase(i));
+  }
+  assert(run_map.size() == 2000);
+  for (int i = 0; i < 4000; ++i) {
+    auto it = run_map.find(i);
+    assert((it == run_map.end()) == (i % 2 == 0));
+    if (i % 2)
+      assert((*it).second == i * 3);
+  }
+  assert(run_map.psl_histogram().size() > 16);
+  cout << "Long probe runs: correct\n";
+
+  // 12b. Default std::hash — the identity on integers, so keys differing
+  // only in high bits would share a home without the map's own mixing
+  RobinHoodMap<long long, int> high_map;
+  for (long long i = 0; i < 300; ++i) {
+    high_map[i << 32] = static_cast<int>(i);
+  }
+  assert(high_map.size() == 300 && high_map.capacity() <= 512);
+  for (long long i = 0; i < 300; ++i) {
+    assert(high_map[i << 32] == static_cast<int>(i));
+  }
+  // A Hash giving every key one value can't be fixed by growing: the map
+  // says so instead of doubling until allocation fails
+  struct ConstHash {
+    size_t operator()(int) const { return 7; }
+  };
+  RobinHoodMap<int, int, ConstHash> const_map;
+  bool refused = false;
+  try {
+    for (int i = 0; i < 1000; ++i) {
+      const_map[i] = i;
+    }
+  } catch (const std::length_error &) {
+    refused = true;
+  }
+  assert(refused && const_map.size() <= 241 && const_map.capacity() < 65536);
+  cout << "High-bit keys: spread by mixing; one-value hash refused\n";
+
+  // 13. SoA layout — same behaviour through parallel key/value arrays
+  RobinHoodMap<Coord, string, CoordHash, equal_to<Coord>, RobinHoodSoA>
+      soa_map;
+  for (int i = 0; i < 500; ++i) {
+    soa_map[{i, -i}] = to_string(i);
+  }
+  for (int i = 0; i < 500; i += 3) {
+    assert((soa_map.erase({i, -i})));
+  }
+  RobinHoodMap<Coord, string, CoordHash, equal_to<Coord>, RobinHoodSoA>
+      soa_moved = std::move(soa_map);
+  size_t soa_count = 0;
+  for (auto [k, v] : soa_moved) {
+    assert(k.x % 3 != 0 && v == to_string(k.x));
+    ++soa_count;
+  }
+  assert(soa_count == soa_moved.size() && soa_count == 333);
+  assert((soa_moved.count({3, -3}) == 0));
+  cout << "SoA layout: correct\n";
+
+  // 14. try_emplace / emplace / insert_or_assign / reserve / rehash
+  RobinHoodMap<Coord, unique_ptr<int>, CoordHash> emp_map;
+  auto [it_a, new_a] = emp_map.try_emplace({1, 1}, make_unique<int>(10));
+  assert(new_a && *(*it_a).second == 10);
+  auto [it_b, new_b] = emp_map.try_emplace({1, 1}, make_unique<int>(20));
+  assert(!new_b && *(*it_b).second == 10); // existing value untouched
+  assert(emp_map.emplace(Coord{2, 2}, new int(30)).second);
+  assert(!emp_map.insert_or_assign({2, 2}, make_unique<int>(31)).second);
+  assert((*emp_map[{2, 2}] == 31));
+  assert(emp_map.insert_or_assign({3, 3}, make_unique<int>(40)).second);
+
+  emp_map.reserve(1000);
+  size_t reserved_cap = emp_map.capacity();
+  assert(reserved_cap * 3 / 4 >= 1000);
+  for (int i = 0; i < 1000; ++i) {
+    emp_map.try_emplace({i, -i - 10}, make_unique<int>(i));
+  }
+  assert(emp_map.capacity() == reserved_cap); // no regrowth
+  for (int i = 0; i < 1000; ++i) {
+    emp_map.erase({i, -i - 10});
+  }
+  emp_map.shrink_to_fit();
+  assert(emp_map.capacity() < reserved_cap && emp_map.size() == 3);
+  emp_map.rehash(4096);
+  assert(emp_map.capacity() == 4096);
+  assert((*emp_map[{1, 1}] == 10 && *emp_map[{2, 2}] == 31 &&
+          *emp_map[{3, 3}] == 40));
+  cout << "Emplace / reserve / rehash: correct\n";
+
+  // 15. Incremental rehash — every operation stays correct while entries
+  // are split between the old and new table
+  RobinHoodMap<Coord, int, CoordHash> inc_map;
+  inc_map.set_incremental_rehash(true);
+  unordered_map<Coord, int, CoordHash> inc_ref;
+  bool saw_migration = false;
+  for (int i = 0; i < 5000; ++i) {
+    Coord k = {i % 71, i / 71};
+    inc_map[k] = i;
+    inc_ref[k] = i;
+    if (i % 7 == 0) {
+      Coord gone = {(i / 2) % 71, (i / 2) / 71};
+      assert(inc_map.erase(gone) == (inc_ref.erase(gone) == 1));
+    }
+    if (inc_map.migrating()) {
+      saw_migration = true;
+      // a key still in the old table: found, updated in place, counted
+      Coord old_key = {1, 0};
+      if (inc_ref.count(old_key)) {
+        assert(inc_map.count(old_key) == 1);
+        assert(!inc_map.try_emplace(old_key, -1).second);
+      }
+      size_t walked = 0;
+      for (auto [key, val] : inc_map) {
+        assert(inc_ref.at(key) == val);
+        ++walked;
+      }
+      assert(walked == inc_ref.size());
+      // const find of a key in the new table walks on into the old one
+      const auto &inc_const = inc_map;
+      size_t before = 0;
+      for (auto it = inc_const.begin(); (*it).first != k; ++it)
+        ++before;
+      size_t after = 0;
+      for (auto it = inc_const.find(k); it != inc_const.end(); ++it)
+        ++after;
+      assert(before + after == inc_ref.size());
+    }
+  }
+  assert(saw_migration && inc_map.size() == inc_ref.size());
+  for (auto &[key, val] : inc_ref) {
+    assert(inc_map.find(key) != inc_map.end() && inc_map[key] == val);
+  }
+  inc_map.set_incremental_rehash(false);
+  assert(!inc_map.migrating());
+  cout << "Incremental rehash: correct\n";
+
+  // 16. find_many — same answers as find, hits and misses mixed, across
+  // more than one batch
+  vector<Coord> batch_keys;
+  for (int i = 0; i < 50; ++i) {
+    batch_keys.push_back({i % 71, i / 71});     // present in inc_map
+    batch_keys.push_back({i + 1000, -i - 1000}); // absent
+  }
+  vector<int *> batch_out(batch_keys.size());
+  size_t batch_found = inc_map.find_many(batch_keys, batch_out);
+  size_t expect_found = 0;
+  for (size_t i = 0; i < batch_keys.size(); ++i) {
+    auto it = inc_map.find(batch_keys[i]);
+    if (it == inc_map.end()) {
+      assert(batch_out[i] == nullptr);
+    } else {
+      assert(batch_out[i] && *batch_out[i] == (*it).second);
+      ++expect_found;
+    }
+  }
+  assert(batch_found == expect_found && batch_found > 0);
+  cout << "find_many: correct (" << batch_found << " of "
+       << batch_keys.size() << " found)\n";
+
+  // 17. ConcurrentRobinHoodMap — move-only values, then four threads each
+  // owning a key range while reading the others'
+  ConcurrentRobinHoodMap<Coord, std::unique_ptr<int>, CoordHash> conc;
+  assert(conc.try_emplace({1, 1}, std::make_unique<int>(5)));
+  assert(!conc.try_emplace({1, 1}, std::make_unique<int>(6)));
+  assert(conc.visit({1, 1}, [](const std::unique_ptr<int> &p) {
+    assert(*p == 5);
+  }));
+  assert(conc.modify({1, 1}, [](std::unique_ptr<int> &p) { *p = 7; }));
+  std::optional<std::unique_ptr<int>> taken = conc.take({1, 1});
+  assert(taken && **taken == 7 && !conc.contains({1, 1}));
+  assert(!conc.take({1, 1}) && conc.size() == 0);
+
+  ConcurrentRobinHoodMap<Coord, int, CoordHash> shared;
+  vector<std::thread> writers;
+  for (int t = 0; t < 4; ++t) {
+    writers.emplace_back([&shared, t] {
+      for (int i = 0; i < 2000; ++i) {
+        shared.insert_or_assign({t, i}, i);
+        shared.contains({(t + 1) % 4, i}); // races another writer's shard
+        if (i % 3 == 0)
+          shared.erase({t, i / 2});
+      }
+    });
+  }
+  for (std::thread &th : writers)
+    th.join();
+  size_t conc_expect = 0;
+  for (int t = 0; t < 4; ++t) {
+    for (int i = 0; i < 2000; ++i) {
+      // {t, j} is erased at step 2j or 2j+1, whichever is a multiple of 3
+      bool erased = i < 1000 && ((2 * i) % 3 == 0 || (2 * i + 1) % 3 == 0);
+      std::optional<int> v = shared.get({t, i});
+      assert(v.has_value() == !erased);
+      conc_expect += !erased;
+    }
+  }
+  assert(shared.size() == conc_expect);
+
+  // Unlocked reads while one writer grows the table under them: every
+  // value read is one that was written, and nothing written goes missing
+  static_assert(ConcurrentRobinHoodMap<Coord, int, CoordHash>::lock_free_reads() ==
+                !RobinHoodStats::enabled);
+  static_assert(!decltype(conc)::lock_free_reads());
+  ConcurrentRobinHoodMap<int, int, std::hash<int>, equal_to<int>, 1> growing;
+  std::atomic<int> written{0};
+  std::atomic<bool> torn{false};
+  std::thread grow_reader([&] {
+    while (written.load() < 20000) {
+      int hi = written.load();
+      for (int k = 0; k < hi; k += 97) {
+        std::optional<int> v = growing.get(k);
+        if (!v || *v != k * 3)
+          torn = true;
+      }
+    }
+  });
+  for (int k = 0; k < 20000; ++k) {
+    growing.insert_or_assign(k, k * 3);
+    written.store(k + 1);
+  }
+  grow_reader.join();
+  assert(!torn && growing.size() == 20000);
+  assert(growing.retired_capacity() < 2 * 32768);
+
+  // Small int keys spread over the shards (std::hash<int> is the identity;
+  // the top bits it leaves zero are mixed before picking a shard)
+  ConcurrentRobinHoodMap<int, int> small_keys;
+  for (int k = 0; k < 256; ++k)
+    small_keys.try_emplace(k, k);
+  size_t busiest = 0;
+  for (size_t i = 0; i < small_keys.shard_count(); ++i)
+    busiest = std::max(busiest, small_keys.shard_size(i));
+  assert(busiest < 64);
+  cout << "Concurrent map: correct (" << conc_expect
+       << " entries), lock-free reads across grows, busiest shard "
+       << busiest << " of 256\n";
+
+  // 18. RobinHoodSet — insert reports new vs duplicate, survives growth and
+  // erase, and iterates every key once
+  RobinHoodSet<Coord, CoordHash> rh_set;
+  assert(rh_set.insert({3, 4}).second);
+  assert(!rh_set.insert({3, 4}).second);
+  assert(rh_set.contains({3, 4}) && !rh_set.contains({4, 3}));
+  std::unordered_set<Coord, CoordHash> set_ref = {{3, 4}};
+  for (int i = 0; i < 3000; ++i) {
+    Coord k = {i % 97, i % 89};
+    assert(rh_set.insert(k).second == set_ref.insert(k).second);
+    if (i % 5 == 0) {
+      Coord gone = {i % 89, i % 97};
+      assert(rh_set.erase(gone) == (set_ref.erase(gone) == 1));
+    }
+  }
+  assert(rh_set.size() == set_ref.size());
+  size_t set_walked = 0;
+  for (const Coord &k : rh_set) {
+    assert(set_ref.count(k));
+    ++set_walked;
+  }
+  assert(set_walked == set_ref.size());
+  cout << "RobinHoodSet: correct (" << rh_set.size() << " keys)\n";
+
+  // 19. Telemetry — counters move with the build flag: zero without
+  // ROBINHOOD_STATS, and with it a hit at home walks exactly one slot
+  RobinHoodMap<int, int> stat_map;
+  for (int i = 0; i < 100; ++i)
+    stat_map[i] = i;
+  stat_map.reset_stats();
+  for (int i = 0; i < 100; ++i)
+    assert(stat_map.count(i) == 1);
+  for (int i = 0; i < 50; ++i)
+    assert(stat_map.erase(i));
+  RobinHoodStats st = stat_map.stats();
+  if constexpr (RobinHoodStats::enabled) {
+    assert(st.probes == 150 && st.erases == 50 && st.grows == 0);
+    assert(st.probe_slots >= st.probes && st.max_probe >= 1);
+  } else {
+    assert(st.probes == 0 && st.erases == 0 && st.probe_slots == 0);
+  }
+  cout << "Telemetry: " << (RobinHoodStats::enabled ? "on" : "off")
+       << ", " << st.probes << " probes counted\n";
+
   cout << "All RobinHood Map tests PASSED!\n";
 }
 
@@ -633,7 +1491,28 @@ int main() {
       cout << "\n========== BENCHMARK RESULTS ==========\n";
       run_aos_vs_soa_benchmark();
       run_hash_benchmark();
+      run_batched_lookup_benchmark();
+      run_concurrent_map_benchmark();
+      run_visited_set_benchmark();
+      run_hash_distribution_report();
+      run_hash_layout_benchmark();
+      run_rehash_latency_benchmark();
       run_bloom_benchmark();
+      run_chunk_storage_benchmark();
+      run_chunk_pool_benchmark();
+      run_render_benchmark();
+      run_residency_benchmark();
+      run_chunk_map_telemetry_report();
+      run_prefetch_benchmark();
+      run_uniform_chunk_benchmark();
+      run_bfs_probe_benchmark();
+      run_mob_tick_benchmark();
+      run_path_context_benchmark();
+      run_reachability_benchmark();
+      run_hpa_benchmark();
+      run_astar_benchmark();
+      run_move_mask_benchmark();
+      run_path_cache_benchmark();
       cout << "\n======= END BENCHMARK RESULTS =========\n";
 
       cout.rdbuf(orig);
@@ -647,6 +1526,8 @@ int main() {
 #endif
 
   World world;
+  world.set_max_resident(World::DEFAULT_MAX_RESIDENT);
+  world.enable_async_generation();
   ScreenBuffer screen;
   CheatState cheats;
 
@@ -726,8 +1607,9 @@ int main() {
     prev_time = now;
 
     InputState input = get_input();
+    bool in_game = windows.top() == &game_window;
 
-    if (windows.top() == &game_window) {
+    if (in_game) {
       game_window.set_dt(dt);
     }
 
@@ -779,6 +1661,12 @@ int main() {
     windows.top()->render(screen);
     screen.render();
 
+    if (in_game) {
+      auto work_end = std::chrono::high_resolution_clock::now();
+      game_window.record_frame_ms(
+          std::chrono::duration<float, std::milli>(work_end - now).count());
+    }
+
 #ifdef _WIN32
     Sleep(16);
 #endif